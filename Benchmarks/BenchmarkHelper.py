@@ -0,0 +1,67 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+# Common functions for benchmark scripts. Benchmarks are run from command line
+# with built ARTKBlender module available in python path, e.g.:
+#   set PYTHONPATH=x64\Release
+#   python Benchmarks\DetectThreadsBenchmark.py
+
+import os
+import time
+import ARTKBlender
+
+dataDir = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'UnitTests', 'Data')
+
+# test images: file name, image size, pixel format, pattern file
+images = {
+  'hiro' : ('hiro_marker.raw', (254, 207), ARTKBlender.ARPixelFormat.RGB, 'hiro.patt'),
+  'camera' : ('test_image.raw', (640, 480), ARTKBlender.ARPixelFormat.RGBA, '4x4_42.patt') }
+
+def dataFile (fileName):
+  return os.path.join(dataDir, fileName)
+
+def loadParam (imgSize):
+  param = ARTKBlender.ARParam()
+  if not param.load(dataFile('camera_para.dat')):
+    raise RuntimeError('Parameters load failed')
+  param.size = imgSize
+  return param
+
+def loadImage (imgName):
+  with open(dataFile(images[imgName][0]), 'rb') as imgFile:
+    return imgFile.read()
+
+def createHandle (imgName, pixelFormat = None, **kwargs):
+  imgFile, imgSize, imgFormat, pattFile = images[imgName]
+  handle = ARTKBlender.ARHandle(loadParam(imgSize), imgFormat if pixelFormat is None else pixelFormat, **kwargs)
+  handle.attachPatt = ARTKBlender.ARPattHandle()
+  handle.attachPatt.load(dataFile(pattFile))
+  return handle
+
+def measure (func, count):
+  '''Calls function count times, returns average time of call in seconds.'''
+  func()
+  start = time.perf_counter()
+  for i in range(count):
+    func()
+  return (time.perf_counter() - start) / count
+
+def report (name, seconds, unit = 'ms'):
+  scale = { 's' : 1.0, 'ms' : 1e3, 'us' : 1e6, 'ns' : 1e9 }[unit]
+  print('{:<48} {:10.3f} {}'.format(name, seconds * scale, unit))
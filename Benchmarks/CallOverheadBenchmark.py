@@ -0,0 +1,48 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+
+# Measures per-call overhead of methods with fast calling convention. Calls are
+# made with arguments rejected early or with cheap work, so the argument passing
+# dominates. Run it with builds before and after a change of method bindings
+# to compare them, e.g. Python 3.7+ build against Python 3.5 one.
+
+import ARTKBlender
+import BenchmarkHelper
+
+callCount = 200000
+
+if __name__ == '__main__':
+  handle = BenchmarkHelper.createHandle('hiro')
+  handle3D = ARTKBlender.AR3DHandle(BenchmarkHelper.loadParam(BenchmarkHelper.images['hiro'][1]))
+  image = BenchmarkHelper.loadImage('hiro')
+  if not handle.detect(image) or len(handle.markers) == 0:
+    raise RuntimeError('Marker detection failed')
+  marker = handle.markers[0]
+  calls = [
+    ('len (reference)', lambda: len(image)),
+    ('ARHandle.detect invalid image', lambda: handle.detect(b'')),
+    ('ARHandle.detect invalid image, timestamp', lambda: handle.detect(b'', 1.0)),
+    ('AR3DHandle.predict unknown id', lambda: handle3D.predict(-1, 1.0)),
+    ('AR3DHandle.predict unknown id, keywords', lambda: handle3D.predict(id=-1, time=1.0)),
+    ('AR3DHandle.getTransMatSquare', lambda: handle3D.getTransMatSquare(marker, 80.0)),
+    ('AR3DHandle.getTransMatSquare, keywords', lambda: handle3D.getTransMatSquare(marker, width=80.0, quaternion=False)) ]
+  for name, func in calls:
+    BenchmarkHelper.report(name, BenchmarkHelper.measure(func, callCount), 'ns')
@@ -0,0 +1,57 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+# Measures frame throughput of ARHandle.detect called from several python threads,
+# each thread runs detection on its own handle, and of ARHandleGroup.detectAll.
+
+import os
+import threading
+import time
+import ARTKBlender
+import BenchmarkHelper
+
+frameCount = 200
+
+def runThreads (handleCount):
+  image = BenchmarkHelper.loadImage('camera')
+  handles = [BenchmarkHelper.createHandle('camera') for i in range(handleCount)]
+  def detectLoop (handle):
+    for i in range(frameCount):
+      handle.detect(image)
+  threads = [threading.Thread(target=detectLoop, args=(handle,)) for handle in handles]
+  start = time.perf_counter()
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  return handleCount * frameCount / (time.perf_counter() - start)
+
+def runGroup (handleCount):
+  image = BenchmarkHelper.loadImage('camera')
+  group = ARTKBlender.ARHandleGroup([BenchmarkHelper.createHandle('camera') for i in range(handleCount)])
+  images = [image] * handleCount
+  return handleCount / BenchmarkHelper.measure(lambda: group.detectAll(images), frameCount)
+
+if __name__ == '__main__':
+  single = runThreads(1)
+  for handleCount in range(1, (os.cpu_count() or 1) + 1):
+    fps = single if handleCount == 1 else runThreads(handleCount)
+    groupFps = runGroup(handleCount)
+    print('{:2} handles: threads {:8.1f} frames/s, scaling {:5.2f}, group {:8.1f} frames/s'.format(
+      handleCount, fps, fps / single, groupFps))
@@ -0,0 +1,54 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+# Measures frames per second and detection rate for combinations of image
+# processing, threshold and pattern detection modes on test images.
+
+import itertools
+import ARTKBlender
+import BenchmarkHelper
+
+frameCount = 100
+
+imageProcModes = ('FRAME_IMAGE', 'FIELD_IMAGE')
+threshModes = ('MANUAL', 'AUTO_MEDIAN', 'AUTO_OTSU', 'AUTO_ADAPTIVE', 'AUTO_BRACKETING')
+patternModes = ('TEMPLATE_MATCHING_COLOR', 'TEMPLATE_MATCHING_MONO')
+
+def runCombination (imgName, image, imageProcMode, threshMode, patternMode):
+  handle = BenchmarkHelper.createHandle(imgName)
+  handle.imageProcMode = getattr(ARTKBlender.ARImageProcMode, imageProcMode)
+  handle.labelingThreshMode = getattr(ARTKBlender.ARLabelingThreshMode, threshMode)
+  handle.patternDetectionMode = getattr(ARTKBlender.ARPatternDetectionMode, patternMode)
+  detected = 0
+  def detect ():
+    nonlocal detected
+    handle.detect(image)
+    if any(marker.id >= 0 for marker in handle.markers):
+      detected += 1
+  seconds = BenchmarkHelper.measure(detect, frameCount)
+  # measure calls function once more before timing
+  return 1.0 / seconds, detected / (frameCount + 1)
+
+if __name__ == '__main__':
+  for imgName in BenchmarkHelper.images:
+    image = BenchmarkHelper.loadImage(imgName)
+    for imageProcMode, threshMode, patternMode in itertools.product(imageProcModes, threshModes, patternModes):
+      fps, rate = runCombination(imgName, image, imageProcMode, threshMode, patternMode)
+      print('{:<6} {:<11} {:<15} {:<23} {:8.1f} frames/s, detection rate {:5.1%}'.format(
+        imgName, imageProcMode, threshMode, patternMode, fps, rate))
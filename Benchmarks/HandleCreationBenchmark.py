@@ -0,0 +1,50 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+
+# Measures creation of ARHandle with new camera configuration, which builds
+# lookup table, and with repeated one, which shares cached table.
+
+import time
+import ARTKBlender
+import BenchmarkHelper
+
+createCount = 20
+
+if __name__ == '__main__':
+  for imgSize in ((640, 480), (1920, 1080)):
+    param = BenchmarkHelper.loadParam(imgSize)
+    # every size differs, so every handle builds its own lookup table
+    handles = []
+    start = time.perf_counter()
+    for i in range(createCount):
+      param.size = (imgSize[0] + i + 1, imgSize[1])
+      handles.append(ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGBA))
+    BenchmarkHelper.report('{}x{} new configuration'.format(*imgSize), (time.perf_counter() - start) / createCount)
+    # the same size, handles share one lookup table
+    param.size = imgSize
+    handles.append(ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGBA))
+    start = time.perf_counter()
+    for i in range(createCount):
+      handles.append(ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGBA))
+    BenchmarkHelper.report('{}x{} repeated configuration'.format(*imgSize), (time.perf_counter() - start) / createCount)
+    stats = ARTKBlender.paramLTCacheStats()
+    print('  cache: {} hits, {} misses, {} tables, {:.1f} MB'.format(stats['hits'], stats['misses'], stats['tables'],
+      stats['memory'] / 1048576.0))
@@ -0,0 +1,60 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+
+# Compares detection with ARToolKit's built-in pixel format handling against
+# detection of luminance plane converted by SIMD kernels of ARHandle for every
+# pixel format derived from camera test image.
+
+import ARTKBlender
+import BenchmarkHelper
+
+detectCount = 100
+
+def deriveImage (rgba, pixelFormat):
+  '''Converts RGBA image to pixel format, luminance of YUV formats is green component.'''
+  channels = { 'R' : rgba[0::4], 'G' : rgba[1::4], 'B' : rgba[2::4], 'A' : rgba[3::4] }
+  pixelCount = len(rgba) // 4
+  layouts = { 'RGB' : 'RGB', 'BGR' : 'BGR', 'RGBA' : 'RGBA', 'BGRA' : 'BGRA', 'ABGR' : 'ABGR', 'ARGB' : 'ARGB',
+    'MONO' : 'G' }
+  if pixelFormat in layouts:
+    layout = layouts[pixelFormat]
+    image = bytearray(pixelCount * len(layout))
+    for i, channel in enumerate(layout):
+      image[i::len(layout)] = channels[channel]
+    return bytes(image)
+  # 4:2:2 formats with neutral chroma
+  image = bytearray([128]) * (pixelCount * 2)
+  image[1 if pixelFormat == 'UYVY' else 0::2] = channels['G']
+  return bytes(image)
+
+if __name__ == '__main__':
+  rgba = BenchmarkHelper.loadImage('camera')
+  for name in ('RGB', 'BGR', 'RGBA', 'BGRA', 'ABGR', 'ARGB', 'UYVY', 'YUY2', 'MONO'):
+    image = deriveImage(rgba, name)
+    handle = BenchmarkHelper.createHandle('camera', getattr(ARTKBlender.ARPixelFormat, name))
+    for convert in (False, True):
+      handle.lumaConversion = convert
+      if not handle.detect(image):
+        raise RuntimeError('Detection failed')
+      markerCount = len(handle.markers)
+      seconds = BenchmarkHelper.measure(lambda: handle.detect(image), detectCount)
+      BenchmarkHelper.report('{:<5} {:<10} {} markers'.format(name, 'converted' if convert else 'built-in', markerCount),
+        seconds)
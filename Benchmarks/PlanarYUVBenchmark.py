@@ -0,0 +1,51 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+
+
+# Compares detection in luminance plane of NV21 frame with conversion of the
+# frame to RGB before detection. Conversion only spreads luminance to color
+# components, so it's the lower bound of cost of real YUV to RGB conversion.
+
+import ARTKBlender
+import BenchmarkHelper
+
+detectCount = 100
+
+def convertToRGB (luma):
+  rgb = bytearray(len(luma) * 3)
+  rgb[0::3] = luma
+  rgb[1::3] = luma
+  rgb[2::3] = luma
+  return rgb
+
+if __name__ == '__main__':
+  rgba = BenchmarkHelper.loadImage('camera')
+  luma = rgba[1::4]
+  frame = luma + bytes([128]) * (len(luma) // 2)
+  planar = BenchmarkHelper.createHandle('camera', ARTKBlender.ARPixelFormat.NV21)
+  rgb = BenchmarkHelper.createHandle('camera', ARTKBlender.ARPixelFormat.RGB)
+  if not planar.detect(frame) or not rgb.detect(convertToRGB(luma)) or len(planar.markers) != len(rgb.markers):
+    raise RuntimeError('Detection failed')
+  BenchmarkHelper.report('NV21 luminance plane', BenchmarkHelper.measure(lambda: planar.detect(frame), detectCount))
+  BenchmarkHelper.report('NV21 planes tuple', BenchmarkHelper.measure(lambda: planar.detect((luma, frame[len(luma):])),
+    detectCount))
+  BenchmarkHelper.report('RGB conversion', BenchmarkHelper.measure(lambda: rgb.detect(convertToRGB(luma)),
+    detectCount))
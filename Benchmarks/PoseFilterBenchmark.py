@@ -0,0 +1,50 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+# Measures cost of ARPoseFilter per marker per frame for several numbers of markers.
+
+import math
+import struct
+import time
+import ARTKBlender
+import BenchmarkHelper
+
+frameCount = 1000
+
+def createPoses (count, frame):
+  values = []
+  for i in range(count):
+    angle = 0.01 * frame + i
+    c, s = math.cos(angle), math.sin(angle)
+    values += [c, -s, 0.0, 10.0 * i, s, c, 0.0, frame * 0.1, 0.0, 0.0, 1.0, -300.0, 0.0, 0.0, 0.0, 1.0]
+  return memoryview(bytearray(struct.pack('{}d'.format(len(values)), *values))).cast('d', (count, 4, 4))
+
+if __name__ == '__main__':
+  for count in (1, 10, 100):
+    poseFilter = ARTKBlender.ARPoseFilter(minCutoff=1.0, beta=0.01)
+    ids = list(range(count))
+    poses = [createPoses(count, frame) for frame in range(16)]
+    out = createPoses(count, 0)
+    frame = [0]
+    def filterFrame ():
+      frame[0] += 1
+      poseFilter.filter(ids, poses[frame[0] % len(poses)], frame[0] / 60.0, out=out)
+    seconds = BenchmarkHelper.measure(filterFrame, frameCount)
+    BenchmarkHelper.report('{:3} markers, per marker per frame'.format(count), seconds / count, 'us')
@@ -0,0 +1,50 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+# Measures detection time for pyramid levels on test image upscaled to high
+# resolution camera frame.
+
+import ARTKBlender
+import BenchmarkHelper
+
+frameCount = 50
+
+def upscaleImage (image, size, pixelSize, factor):
+  '''Upscales image by integer factor using nearest pixel.'''
+  rows = []
+  rowSize = size[0] * pixelSize
+  for y in range(size[1]):
+    row = image[y * rowSize : (y + 1) * rowSize]
+    row = b''.join(row[x : x + pixelSize] * factor for x in range(0, rowSize, pixelSize))
+    rows.extend([row] * factor)
+  return b''.join(rows)
+
+if __name__ == '__main__':
+  for factor in (1, 2, 3):
+    imgFile, imgSize, imgFormat, pattFile = BenchmarkHelper.images['camera']
+    image = upscaleImage(BenchmarkHelper.loadImage('camera'), imgSize, 4, factor)
+    size = (imgSize[0] * factor, imgSize[1] * factor)
+    handle = ARTKBlender.ARHandle(BenchmarkHelper.loadParam(size), imgFormat)
+    handle.attachPatt = ARTKBlender.ARPattHandle()
+    handle.attachPatt.load(BenchmarkHelper.dataFile(pattFile))
+    for level in range(3):
+      handle.pyramidLevel = level
+      seconds = BenchmarkHelper.measure(lambda: handle.detect(image), frameCount)
+      BenchmarkHelper.report('{}x{} pyramid level {}, {} markers'.format(size[0], size[1], level,
+        len(handle.markers)), seconds)
@@ -0,0 +1,72 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+
+
+# Compares CPU time per frame of full detection with incremental detection of
+# changed tiles on synthetic sequence, where hiro marker moves over static
+# background of camera test image.
+
+import time
+import ARTKBlender
+import BenchmarkHelper
+
+frameCount = 60
+
+def createFrames ():
+  '''Pastes hiro image to camera image at positions along diagonal.'''
+  background = BenchmarkHelper.loadImage('camera')
+  width, height = BenchmarkHelper.images['camera'][1]
+  rgb = BenchmarkHelper.loadImage('hiro')
+  markerWidth, markerHeight = BenchmarkHelper.images['hiro'][1]
+  marker = bytearray([255]) * (markerWidth * markerHeight * 4)
+  for i in range(3):
+    marker[i::4] = rgb[i::3]
+  frames = []
+  for i in range(frameCount):
+    x = (width - markerWidth) * i // frameCount
+    y = (height - markerHeight) * i // frameCount
+    frame = bytearray(background)
+    for row in range(markerHeight):
+      start = ((y + row) * width + x) * 4
+      frame[start:start + markerWidth * 4] = marker[row * markerWidth * 4:(row + 1) * markerWidth * 4]
+    frames.append(bytes(frame))
+  return frames
+
+def measureSequence (handle, frames):
+  '''Detects markers in all frames, returns average CPU time per frame and number of detected markers.'''
+  markerCount = 0
+  start = time.process_time()
+  for frame in frames:
+    if not handle.detect(frame):
+      raise RuntimeError('Detection failed')
+    markerCount += len(handle.markers)
+  return (time.process_time() - start) / len(frames), markerCount
+
+if __name__ == '__main__':
+  frames = createFrames()
+  handle = BenchmarkHelper.createHandle('camera')
+  handle.attachPatt.load(BenchmarkHelper.dataFile('hiro.patt'))
+  for incremental in (False, True):
+    handle.tileDetection = incremental
+    seconds, markerCount = measureSequence(handle, frames)
+    BenchmarkHelper.report('{:<11} {} markers'.format('incremental' if incremental else 'full', markerCount), seconds)
+    if incremental:
+      print(handle.tileStats)
@@ -24,7 +24,14 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #include "ARParam.h"
 #include "ARMarkerInfo.h"
 #include "PyObjectHelper.h"
+#include "PyFastCall.h"
 #include "PyTypeRegistration.h"
+#include "MatrixUtils.h"
+#include "PoseCache.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace ARTKBlender
 {
@@ -37,6 +44,8 @@ PyObject * PyAR3DHandle_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
   // initialize object structure
   PyAR3DHandle * selfObj = getPyType<PyAR3DHandle>(self);
   selfObj->handle = nullptr;
+  selfObj->lock = new std::mutex;
+  selfObj->poses = new PoseCache;
   // return allocated object
   return self;
 }
@@ -46,6 +55,8 @@ void PyAR3DHandle_dealloc(PyAR3DHandle * self)
 {
   // release data
   ar3DDeleteHandle(&self->handle);
+  delete self->lock;
+  delete self->poses;
   // release object
   deallocPyObject(self);
 }
@@ -67,72 +78,320 @@ int PyAR3DHandle_init(PyAR3DHandle * self, PyObject *args, PyObject *kwds)
   return 0;
 }
 
-// return tuple with matrix values
-static PyObject * buildMatrix(double mat[][4])
-{
-  // build matrix rows
-  return Py_BuildValue("((dddd)(dddd)(dddd)(dddd))", mat[0][0], mat[0][1], mat[0][2], mat[0][3],
-    -mat[1][0], -mat[1][1], -mat[1][2], -mat[1][3], -mat[2][0], -mat[2][1], -mat[2][2], -mat[2][3],
-    0.0, 0.0, 0.0, 1.0);
-}
-
-// detect markers in image data
-PyObject * PyAR3DHandle_getTransMatSquare(PyAR3DHandle * self, PyObject * args)
+// get transformation matrix of marker
+PyObject * PyAR3DHandle_getTransMatSquare(PyAR3DHandle * self, PyObject * const * args, Py_ssize_t nargs,
+  PyObject * kwnames)
 {
   // get arguments
-  PyObject * marker;
+  static const char * const names[] = { "marker", "width", "out", "quaternion" };
+  PyObject * values[] = { nullptr, nullptr, Py_None, Py_False };
   double width;
-  if (!PyArg_ParseTuple(args, "O!d", &ARMarkerInfoType, &marker, &width))
-    Py_RETURN_NONE;
+  bool quaternion;
+  if (!unpackFastArgs("getTransMatSquare", args, nargs, kwnames, names, 2, values) ||
+      !checkArgType("getTransMatSquare", values[0], ARMarkerInfoType) || !getArgDouble(values[1], width) ||
+      !getArgBool(values[3], quaternion))
+    return NULL;
+  PyObject * marker = values[0];
+  PyObject * out = values[2];
 
   // process image data to detect markers
   double mat[3][4];
-  double err = arGetTransMatSquare(self->handle, getPyType<PyARMarkerInfo>(marker)->marker, width, mat);
+  PyMutexLock lock(*self->lock);
+  double err = arGetTransMatSquare(self->handle, &getPyType<PyARMarkerInfo>(marker)->marker, width, mat);
 
-  // return matrix tuple
-  return buildMatrix(mat);
+  // return pose
+  return returnPose(mat, out, quaternion);
 }
 
-// detect markers in image data
-PyObject * PyAR3DHandle_getTransMatSquareCont(PyAR3DHandle * self, PyObject * args)
+// get transformation matrix of marker continuing from previous matrix
+PyObject * PyAR3DHandle_getTransMatSquareCont(PyAR3DHandle * self, PyObject * const * args, Py_ssize_t nargs,
+  PyObject * kwnames)
 {
   // get arguments
-  PyObject * marker;
+  static const char * const names[] = { "marker", "width", "matrix", "out", "quaternion" };
+  PyObject * values[] = { nullptr, nullptr, nullptr, Py_None, Py_False };
   double width;
+  bool quaternion;
   double mat[4][4];
-  if (!PyArg_ParseTuple(args, "O!d((dddd)(dddd)(dddd)(dddd))", &ARMarkerInfoType, &marker, &width,
-      &mat[0][0], &mat[0][1], &mat[0][2], &mat[0][3], &mat[1][0], &mat[1][1], &mat[1][2], &mat[1][3],
-      &mat[2][0], &mat[2][1], &mat[2][2], &mat[2][3], &mat[3][0], &mat[3][1], &mat[3][2], &mat[3][3]))
-    Py_RETURN_NONE;
+  if (!unpackFastArgs("getTransMatSquareCont", args, nargs, kwnames, names, 3, values) ||
+      !checkArgType("getTransMatSquareCont", values[0], ARMarkerInfoType) || !getArgDouble(values[1], width) ||
+      !getArgBool(values[4], quaternion))
+    return NULL;
+  if (!parseMatrixTuple(values[2], mat))
+    return NULL;
+  PyObject * marker = values[0];
+  PyObject * out = values[3];
 
   // invert values in the second and third row
-  for (size_t i = 1; i < 3; ++i)
-    for (size_t j = 0; j < 4; ++j)
-      mat[i][j] = -mat[i][j];
+  double conv[3][4];
+  fromBlenderMatrix(mat, conv);
 
   // process image data to detect markers
-  double err = arGetTransMatSquareCont(self->handle, getPyType<PyARMarkerInfo>(marker)->marker, mat, width, mat);
+  PyMutexLock lock(*self->lock);
+  double err = arGetTransMatSquareCont(self->handle, &getPyType<PyARMarkerInfo>(marker)->marker, conv, width, conv);
+
+  // return pose
+  return returnPose(conv, out, quaternion);
+}
+
+// get transformation matrices of several markers
+PyObject * PyAR3DHandle_getTransMatSquareBatch(PyAR3DHandle * self, PyObject * args, PyObject * kwds)
+{
+  // get arguments
+  PyObject * markersArg;
+  PyObject * widthsArg;
+  PyObject * out = Py_None;
+  static char *kwlist[] = { "markers", "widths", "out", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O", kwlist, &markersArg, &widthsArg, &out))
+    return NULL;
+
+  // get markers
+  PyObjectOwner markersSeq(PySequence_Fast(markersArg, "Markers have to be sequence of ARMarkerInfo objects"));
+  if (markersSeq.isNull())
+    return NULL;
+  Py_ssize_t count = PySequence_Fast_GET_SIZE(markersSeq.get());
+  // markers are copied, sequence may be changed by other thread during computation
+  std::vector<ARMarkerInfo> markers(count);
+  for (Py_ssize_t i = 0; i < count; ++i)
+  {
+    PyObject * marker = PySequence_Fast_GET_ITEM(markersSeq.get(), i);
+    if (!isInstance(marker, ARMarkerInfoType))
+    {
+      PyErr_SetString(PyExc_TypeError, "Markers have to be sequence of ARMarkerInfo objects");
+      return NULL;
+    }
+    markers[i] = getPyType<PyARMarkerInfo>(marker)->marker;
+  }
+
+  // get widths, single number is used for all markers
+  std::vector<double> widths(count);
+  if (PyNumber_Check(widthsArg))
+  {
+    double width = PyFloat_AsDouble(widthsArg);
+    if (PyErr_Occurred())
+      return NULL;
+    std::fill(widths.begin(), widths.end(), width);
+  }
+  else
+  {
+    PyObjectOwner widthsSeq(PySequence_Fast(widthsArg, "Widths have to be number or sequence of numbers"));
+    if (widthsSeq.isNull())
+      return NULL;
+    if (PySequence_Fast_GET_SIZE(widthsSeq.get()) != count)
+    {
+      PyErr_SetString(PyExc_ValueError, "Number of widths has to match number of markers");
+      return NULL;
+    }
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+      widths[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(widthsSeq.get(), i));
+      if (PyErr_Occurred())
+        return NULL;
+    }
+  }
+
+  // get output buffer, or allocate new one
+  PyObjectOwner result(out == Py_None ? createMatrixBuffer(count) : out, out != Py_None);
+  if (result.isNull())
+    return NULL;
+  Py_buffer buffer;
+  if (!getMatrixBuffer(result.get(), &buffer, count, true))
+    return NULL;
+
+  // compute transformations without interpreter lock
+  std::vector<double> errors(count);
+  {
+    PyAllowThreads allowThreads;
+    std::lock_guard<std::mutex> lock(*self->lock);
+    double (*mats)[4][4] = reinterpret_cast<double(*)[4][4]>(buffer.buf);
+    for (Py_ssize_t i = 0; i < count; ++i)
+    {
+      double conv[3][4];
+      errors[i] = arGetTransMatSquare(self->handle, &markers[i], widths[i], conv);
+      toBlenderMatrix(conv, mats[i]);
+    }
+  }
+  PyBuffer_Release(&buffer);
+
+  // return matrices with errors
+  PyObjectOwner errorsTuple(PyTuple_New(count));
+  if (errorsTuple.isNull())
+    return NULL;
+  for (Py_ssize_t i = 0; i < count; ++i)
+    PyTuple_SET_ITEM(errorsTuple.get(), i, PyFloat_FromDouble(errors[i]));
+  return Py_BuildValue("(OO)", result.get(), errorsTuple.get());
+}
+
+// get transformation matrix continuing from previous pose of marker
+PyObject * PyAR3DHandle_getPose(PyAR3DHandle * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames)
+{
+  // get arguments
+  static const char * const names[] = { "marker", "width", "out", "quaternion" };
+  PyObject * values[] = { nullptr, nullptr, Py_None, Py_False };
+  double width;
+  bool quaternion;
+  if (!unpackFastArgs("getPose", args, nargs, kwnames, names, 2, values) ||
+      !checkArgType("getPose", values[0], ARMarkerInfoType) || !getArgDouble(values[1], width) ||
+      !getArgBool(values[3], quaternion))
+    return NULL;
+  PyObject * marker = values[0];
+  PyObject * out = values[2];
+
+  // solve pose from previous one, if it's available
+  double conv[3][4];
+  PyARMarkerInfo * markerObj = getPyType<PyARMarkerInfo>(marker);
+  PyMutexLock lock(*self->lock);
+  self->poses->solve(self->handle, markerObj->marker, width, markerObj->timestamp, conv);
+
+  // return pose
+  return returnPose(conv, out, quaternion);
+}
+
+// extrapolate pose of marker to display time
+PyObject * PyAR3DHandle_predict(PyAR3DHandle * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames)
+{
+  // get arguments
+  static const char * const names[] = { "id", "time", "out", "quaternion" };
+  PyObject * values[] = { nullptr, Py_None, Py_None, Py_False };
+  int id;
+  double time;
+  bool quaternion;
+  if (!unpackFastArgs("predict", args, nargs, kwnames, names, 1, values) || !getArgInt(values[0], id) ||
+      !getTimestamp(values[1], time) || !getArgBool(values[3], quaternion))
+    return NULL;
+  PyObject * out = values[2];
+
+  // extrapolate the last pose of marker
+  double conv[3][4];
+  PyMutexLock lock(*self->lock);
+  if (!self->poses->predict(id, time, conv))
+    Py_RETURN_NONE;
+
+  // return pose
+  return returnPose(conv, out, quaternion);
+}
+
+// forget previous poses of markers
+PyObject * PyAR3DHandle_resetPoses(PyAR3DHandle * self)
+{
+  PyMutexLock lock(*self->lock);
+  self->poses->clear();
+  Py_RETURN_NONE;
+}
+
+
+// get expiry time of previous poses
+PyObject * PyAR3DHandle_getPoseExpiry(PyAR3DHandle * self, void * closure)
+{
+  return PyFloat_FromDouble(self->poses->expiry);
+}
+
+// set expiry time of previous poses
+int PyAR3DHandle_setPoseExpiry(PyAR3DHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  double expiry = value != NULL ? PyFloat_AsDouble(value) : -1.0;
+  if (expiry < 0.0)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be non-negative number");
+    return -1;
+  }
+  // set new value
+  PyMutexLock lock(*self->lock);
+  self->poses->expiry = expiry;
+  return 0;
+}
+
+// get error threshold of poses
+PyObject * PyAR3DHandle_getPoseErrorThreshold(PyAR3DHandle * self, void * closure)
+{
+  return PyFloat_FromDouble(self->poses->errorThreshold);
+}
+
+// set error threshold of poses
+int PyAR3DHandle_setPoseErrorThreshold(PyAR3DHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  double threshold = value != NULL ? PyFloat_AsDouble(value) : -1.0;
+  if (threshold <= 0.0)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be positive number");
+    return -1;
+  }
+  // set new value
+  PyMutexLock lock(*self->lock);
+  self->poses->errorThreshold = threshold;
+  return 0;
+}
 
-  // return matrix tuple
-  return buildMatrix(mat);
+// get limit of pose extrapolation
+PyObject * PyAR3DHandle_getPredictionLimit(PyAR3DHandle * self, void * closure)
+{
+  return PyFloat_FromDouble(self->poses->predictionLimit);
+}
+
+// set limit of pose extrapolation
+int PyAR3DHandle_setPredictionLimit(PyAR3DHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  double limit = value != NULL ? PyFloat_AsDouble(value) : -1.0;
+  if (limit < 0.0)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be non-negative number");
+    return -1;
+  }
+  // set new value
+  PyMutexLock lock(*self->lock);
+  self->poses->predictionLimit = limit;
+  return 0;
+}
+
+// get statistics of pose solves
+PyObject * PyAR3DHandle_getPoseStats(PyAR3DHandle * self, void * closure)
+{
+  PyMutexLock lock(*self->lock);
+  return Py_BuildValue("{sKsK}", "continuous", self->poses->continuousSolves, "fresh", self->poses->freshSolves);
 }
 
 
 // members descriptions
 PyGetSetDef PyAR3DHandle_getseters[] =
 {
-  /*{ "pixelFormat", (getter)PyARHandle_getPixelFormat, NULL,
-  "pixel format", NULL },*/
+  { "poseExpiry", (getter)PyAR3DHandle_getPoseExpiry, (setter)PyAR3DHandle_setPoseExpiry,
+  "maximal age in seconds of previous pose used by getPose", NULL },
+  { "poseErrorThreshold", (getter)PyAR3DHandle_getPoseErrorThreshold, (setter)PyAR3DHandle_setPoseErrorThreshold,
+  "maximal fit error of pose kept for getPose", NULL },
+  { "predictionLimit", (getter)PyAR3DHandle_getPredictionLimit, (setter)PyAR3DHandle_setPredictionLimit,
+  "maximal time in seconds, for which predict extrapolates pose", NULL },
+  { "poseStats", (getter)PyAR3DHandle_getPoseStats, NULL,
+  "dictionary with numbers of continuous and fresh solves of getPose", NULL },
   { NULL }  /* Sentinel */
 };
 
 /// methods descriptions
 PyMethodDef PyAR3DHandle_methods[] =
 {
-  { "getTransMatSquare", (PyCFunction)PyAR3DHandle_getTransMatSquare, METH_VARARGS,
-  "Get transformation matrix for detected square marker with specified width." },
-  { "getTransMatSquareCont", (PyCFunction)PyAR3DHandle_getTransMatSquareCont, METH_VARARGS,
-  "Get transformation matrix for detected square marker with specified width continuing from previous matrix." },
+  { "getTransMatSquare", PY_FASTCALL_METHOD(PyAR3DHandle, PyAR3DHandle_getTransMatSquare),
+  "Get transformation matrix for detected square marker with specified width, "
+  "written to out buffer or as quaternion with translation, if requested." },
+  { "getTransMatSquareCont", PY_FASTCALL_METHOD(PyAR3DHandle, PyAR3DHandle_getTransMatSquareCont),
+  "Get transformation matrix for detected square marker with specified width continuing from previous matrix, "
+  "written to out buffer or as quaternion with translation, if requested." },
+  { "getTransMatSquareBatch", (PyCFunction)PyAR3DHandle_getTransMatSquareBatch, METH_VARARGS | METH_KEYWORDS,
+  "Get transformation matrices for sequence of markers with width or sequence of widths, "
+  "return (N,4,4) float64 buffer, which may be supplied as out, and tuple of fit errors." },
+  { "getPose", PY_FASTCALL_METHOD(PyAR3DHandle, PyAR3DHandle_getPose),
+  "Get transformation matrix for marker with specified width, continuing from recent pose of the same pattern ID, "
+  "written to out buffer or as quaternion with translation, if requested." },
+  { "predict", PY_FASTCALL_METHOD(PyAR3DHandle, PyAR3DHandle_predict),
+  "Get transformation matrix of marker with pattern ID extrapolated to display time in seconds (default now) "
+  "from poses solved by getPose, written to out buffer or as quaternion with translation, if requested, "
+  "return None if no recent pose is available." },
+  { "resetPoses", (PyCFunction)PyAR3DHandle_resetPoses, METH_NOARGS,
+  "Forget previous poses of markers." },
   { NULL }  /* Sentinel */
 };
 
@@ -169,7 +428,7 @@ PyTypeObject AR3DHandleType =
   0,                         /* tp_iternext */
   PyAR3DHandle_methods,      /* tp_methods */
   0,                         /* tp_members */
-  0, //PyAR3DHandle_getseters,      /* tp_getset */
+  PyAR3DHandle_getseters,    /* tp_getset */
   0,                         /* tp_base */
   0,                         /* tp_dict */
   0,                         /* tp_descr_get */
@@ -23,16 +23,23 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <AR/ar.h>
 #include <Python.h>
+#include <mutex>
 
 namespace ARTKBlender
 {
 
+class PoseCache;
+
 /// python data structure for AR3DHandle
 struct PyAR3DHandle
 {
   PyObject_HEAD
   /// AR3DHandle structure
   AR3DHandle * handle;
+  /// lock of AR3DHandle structure, it's acquired only with released interpreter lock
+  std::mutex * lock;
+  /// last poses of markers
+  PoseCache * poses;
 };
 
 // declaration of python module type
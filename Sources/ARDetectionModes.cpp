@@ -0,0 +1,171 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ARDetectionModes.h"
+
+#include "PyObjectHelper.h"
+#include "PyTypeRegistration.h"
+
+namespace ARTKBlender
+{
+
+/// python type structure for ARImageProcMode
+PyTypeObject ARImageProcModeType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARImageProcMode", /* tp_name */
+  sizeof(PyARDetectionMode), /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  0,                         /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARImageProcMode enumeration", /* tp_doc */
+};
+
+// enumeration values
+PyTypeRegistrationEnum::EnumMap imageProcModeMap =
+  { { "FRAME_IMAGE", AR_IMAGE_PROC_FRAME_IMAGE },{ "FIELD_IMAGE", AR_IMAGE_PROC_FIELD_IMAGE } };
+
+// registration object
+static PyTypeRegistrationEnum ARImageProcModeReg("ARImageProcMode", ARImageProcModeType, imageProcModeMap);
+
+
+/// python type structure for ARLabelingMode
+PyTypeObject ARLabelingModeType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARLabelingMode", /* tp_name */
+  sizeof(PyARDetectionMode), /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  0,                         /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARLabelingMode enumeration", /* tp_doc */
+};
+
+// enumeration values
+PyTypeRegistrationEnum::EnumMap labelingModeMap =
+  { { "WHITE_REGION", AR_LABELING_WHITE_REGION },{ "BLACK_REGION", AR_LABELING_BLACK_REGION } };
+
+// registration object
+static PyTypeRegistrationEnum ARLabelingModeReg("ARLabelingMode", ARLabelingModeType, labelingModeMap);
+
+
+/// python type structure for ARLabelingThreshMode
+PyTypeObject ARLabelingThreshModeType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARLabelingThreshMode", /* tp_name */
+  sizeof(PyARDetectionMode), /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  0,                         /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARLabelingThreshMode enumeration", /* tp_doc */
+};
+
+// enumeration values
+PyTypeRegistrationEnum::EnumMap labelingThreshModeMap =
+  { { "MANUAL", AR_LABELING_THRESH_MODE_MANUAL },
+  { "AUTO_MEDIAN", AR_LABELING_THRESH_MODE_AUTO_MEDIAN },{ "AUTO_OTSU", AR_LABELING_THRESH_MODE_AUTO_OTSU },
+  { "AUTO_ADAPTIVE", AR_LABELING_THRESH_MODE_AUTO_ADAPTIVE },
+  { "AUTO_BRACKETING", AR_LABELING_THRESH_MODE_AUTO_BRACKETING } };
+
+// registration object
+static PyTypeRegistrationEnum ARLabelingThreshModeReg("ARLabelingThreshMode", ARLabelingThreshModeType, labelingThreshModeMap);
+
+
+/// python type structure for ARPatternDetectionMode
+PyTypeObject ARPatternDetectionModeType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARPatternDetectionMode", /* tp_name */
+  sizeof(PyARDetectionMode), /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  0,                         /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARPatternDetectionMode enumeration", /* tp_doc */
+};
+
+// enumeration values
+PyTypeRegistrationEnum::EnumMap patternDetectionModeMap =
+  { { "TEMPLATE_MATCHING_COLOR", AR_TEMPLATE_MATCHING_COLOR },
+  { "TEMPLATE_MATCHING_MONO", AR_TEMPLATE_MATCHING_MONO },{ "MATRIX_CODE_DETECTION", AR_MATRIX_CODE_DETECTION },
+  { "TEMPLATE_MATCHING_COLOR_AND_MATRIX", AR_TEMPLATE_MATCHING_COLOR_AND_MATRIX },
+  { "TEMPLATE_MATCHING_MONO_AND_MATRIX", AR_TEMPLATE_MATCHING_MONO_AND_MATRIX } };
+
+// registration object
+static PyTypeRegistrationEnum ARPatternDetectionModeReg("ARPatternDetectionMode", ARPatternDetectionModeType, patternDetectionModeMap);
+
+}
\ No newline at end of file
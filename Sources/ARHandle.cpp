@@ -24,9 +24,20 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #include "ARParam.h"
 #include "ARPattHandle.h"
 #include "ARMarkerInfo.h"
+#include "ARMarkerArray.h"
 #include "PyObjectHelper.h"
+#include "PyFastCall.h"
 #include "PyTypeRegistration.h"
 #include "BlenderUtils.h"
+#include "TimeUtils.h"
+#include "TrackingThread.h"
+#include "RegionDetector.h"
+#include "PyramidDetector.h"
+#include "TileDetector.h"
+#include "ParamLTCache.h"
+#include "ImageUtils.h"
+
+#include <algorithm>
 
 namespace ARTKBlender
 {
@@ -42,7 +53,33 @@ PyObject * PyARHandle_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
   selfObj->paramLT = nullptr;
   selfObj->attachPatt = new PyObjectOwner;
   selfObj->markers = new PyObjectOwner(PyTuple_New(0));
+  selfObj->markerPool = new ARMarkerInfoPool;
   selfObj->updateMarkers = false;
+  selfObj->markerArray = new PyObjectOwner;
+  selfObj->updateMarkerArray = true;
+  selfObj->lock = new std::mutex;
+  selfObj->markerInfo = new ARMarkerInfo[AR_SQUARE_MAX];
+  selfObj->markerNum = 0;
+  selfObj->markerTime = 0.0;
+  selfObj->detectionLatency = 0.0;
+  selfObj->tracking = nullptr;
+  selfObj->polledSequence = 0;
+  selfObj->regionTracker = new RegionTracker;
+  selfObj->pyramid = new PyramidDetector;
+  selfObj->tiles = new TileDetector;
+  selfObj->pixelFormat = AR_PIXEL_FORMAT_INVALID;
+  selfObj->lumaConversion = false;
+  selfObj->bottomOrigin = false;
+  selfObj->lumaBuffer = new AlignedBuffer;
+  selfObj->packBuffer = new AlignedBuffer;
+  selfObj->directImages = 0;
+  selfObj->convertedImages = 0;
+  selfObj->repackedImages = 0;
+  selfObj->frameSkipping = false;
+  selfObj->frameFingerprint = 0;
+  selfObj->frameSkipped = false;
+  selfObj->fingerprintHits = 0;
+  selfObj->fingerprintMisses = 0;
   // return allocated object
   return self;
 }
@@ -50,12 +87,31 @@ PyObject * PyARHandle_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 // ARHandle object deallocation
 void PyARHandle_dealloc(PyARHandle * self)
 {
+  // stop tracking thread, it may wait for handle locked by thread waiting for interpreter lock
+  if (self->tracking != nullptr)
+  {
+    PyAllowThreads allowThreads;
+    delete self->tracking;
+  }
   // release data
   arPattDetach(self->handle);
   arDeleteHandle(self->handle);
-  arParamLTFree(&self->paramLT);
+  if (self->paramLT != nullptr)
+  {
+    PyAllowThreads allowThreads;
+    ParamLTCache::getInstance().release(self->paramLT);
+  }
   delete self->attachPatt;
   delete self->markers;
+  delete self->markerPool;
+  delete self->markerArray;
+  delete self->lock;
+  delete[] self->markerInfo;
+  delete self->regionTracker;
+  delete self->pyramid;
+  delete self->tiles;
+  delete self->lumaBuffer;
+  delete self->packBuffer;
   // release object
   deallocPyObject(self);
 }
@@ -66,16 +122,21 @@ int PyARHandle_init(PyARHandle * self, PyObject *args, PyObject *kwds)
   // parse parameter
   PyObject *param = NULL;
   int pixFmt = -1;
-  static char *kwlist[] = { "param", "pixelFormat", NULL };
-  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!i", kwlist, &ARParamType, &param, &pixFmt))
+  const char * lookupTable = nullptr;
+  static char *kwlist[] = { "param", "pixelFormat", "lookupTable", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!i|z", kwlist, &ARParamType, &param, &pixFmt, &lookupTable))
     return -1;
 
   // check pixel format
   if (pixFmt < AR_PIXEL_FORMAT_INVALID || pixFmt > AR_PIXEL_FORMAT_MAX)
     return -1;
 
-  // create lookup table
-  self->paramLT = arParamLTCreate(getPyType<PyARParam>(param)->param, AR_PARAM_LT_DEFAULT_OFFSET);
+  // get shared lookup table mapped from valid snapshot or created, creation
+  // of new one takes time, so interpreter lock is released
+  ARParam arParam = *getPyType<PyARParam>(param)->param;
+  PyAllowThreads allowThreads;
+  self->paramLT = ParamLTCache::getInstance().acquire(arParam, AR_PARAM_LT_DEFAULT_OFFSET, lookupTable);
+  allowThreads.restore();
   if (self->paramLT == nullptr)
     return -1;
 
@@ -85,7 +146,8 @@ int PyARHandle_init(PyARHandle * self, PyObject *args, PyObject *kwds)
     return -1;
 
   // set pixel format
-  if (arSetPixelFormat(self->handle, AR_PIXEL_FORMAT(pixFmt)) < 0)
+  self->pixelFormat = AR_PIXEL_FORMAT(pixFmt);
+  if (arSetPixelFormat(self->handle, self->pixelFormat) < 0)
     return -1;
 
   return 0;
@@ -95,7 +157,162 @@ int PyARHandle_init(PyARHandle * self, PyObject *args, PyObject *kwds)
 // get pixel format
 PyObject * PyARHandle_getPixelFormat(PyARHandle * self, void * closure)
 {
-  return Py_BuildValue("i", self->handle->arPixelFormat);
+  return Py_BuildValue("i", self->pixelFormat);
+}
+
+// get image size
+PyObject * PyARHandle_getSize(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return Py_BuildValue("(ii)", self->handle->xsize, self->handle->ysize);
+}
+
+// convert value to integer from range, set python error if it isn't valid
+static bool getRangeValue(PyObject * value, long minValue, long maxValue, int & result)
+{
+  long number = value != NULL && PyLong_Check(value) ? PyLong_AsLong(value) : minValue - 1;
+  if (number < minValue || number > maxValue)
+  {
+    PyErr_Clear();
+    PyErr_Format(PyExc_ValueError, "Value has to be integer from %ld to %ld", minValue, maxValue);
+    return false;
+  }
+  result = int(number);
+  return true;
+}
+
+// check result of handle setting, set python error if it failed
+static int checkSetResult(int result)
+{
+  if (result < 0)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Setting of handle value failed");
+    return -1;
+  }
+  return 0;
+}
+
+// get image processing mode
+PyObject * PyARHandle_getImageProcMode(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return PyLong_FromLong(self->handle->arImageProcMode);
+}
+
+// set image processing mode
+int PyARHandle_setImageProcMode(PyARHandle * self, PyObject *value, void *closure)
+{
+  int mode;
+  if (!getRangeValue(value, AR_IMAGE_PROC_FRAME_IMAGE, AR_IMAGE_PROC_FIELD_IMAGE, mode))
+    return -1;
+  ARHandleLock lock(self);
+  return checkSetResult(arSetImageProcMode(self->handle, mode));
+}
+
+// get labeling mode
+PyObject * PyARHandle_getLabelingMode(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return PyLong_FromLong(self->handle->arLabelingMode);
+}
+
+// set labeling mode
+int PyARHandle_setLabelingMode(PyARHandle * self, PyObject *value, void *closure)
+{
+  int mode;
+  if (!getRangeValue(value, AR_LABELING_WHITE_REGION, AR_LABELING_BLACK_REGION, mode))
+    return -1;
+  ARHandleLock lock(self);
+  return checkSetResult(arSetLabelingMode(self->handle, mode));
+}
+
+// get border size of markers
+PyObject * PyARHandle_getBorderSize(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return PyFloat_FromDouble((1.0 - self->handle->pattRatio) * 0.5);
+}
+
+// set border size of markers
+int PyARHandle_setBorderSize(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value, border has to leave space for pattern
+  double borderSize = value != NULL ? PyFloat_AsDouble(value) : 0.0;
+  if (borderSize <= 0.0 || borderSize >= 0.5)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be number between 0 and 0.5");
+    return -1;
+  }
+  ARHandleLock lock(self);
+  return checkSetResult(arSetBorderSize(self->handle, borderSize));
+}
+
+// get labeling threshold mode
+PyObject * PyARHandle_getLabelingThreshMode(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return PyLong_FromLong(self->handle->arLabelingThreshMode);
+}
+
+// check if labeling threshold mode is supported by pyramid, region and tile detection
+static bool checkThreshMode(int mode, bool partialLabeling)
+{
+  // adaptive threshold image and bracketing are computed only by full image detection
+  if (partialLabeling
+    && (mode == AR_LABELING_THRESH_MODE_AUTO_ADAPTIVE || mode == AR_LABELING_THRESH_MODE_AUTO_BRACKETING))
+  {
+    PyErr_SetString(PyExc_ValueError,
+      "Pyramid, ROI and tile detection support only manual, median and Otsu labeling threshold modes");
+    return false;
+  }
+  return true;
+}
+
+// set labeling threshold mode
+int PyARHandle_setLabelingThreshMode(PyARHandle * self, PyObject *value, void *closure)
+{
+  int mode;
+  if (!getRangeValue(value, AR_LABELING_THRESH_MODE_MANUAL, AR_LABELING_THRESH_MODE_AUTO_BRACKETING, mode))
+    return -1;
+  ARHandleLock lock(self);
+  if (!checkThreshMode(mode, self->pyramid->levels > 0 || self->regionTracker->enabled || self->tiles->enabled))
+    return -1;
+  return checkSetResult(arSetLabelingThreshMode(self->handle, AR_LABELING_THRESH_MODE(mode)));
+}
+
+// get labeling threshold
+PyObject * PyARHandle_getLabelingThresh(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return PyLong_FromLong(self->handle->arLabelingThresh);
+}
+
+// set labeling threshold
+int PyARHandle_setLabelingThresh(PyARHandle * self, PyObject *value, void *closure)
+{
+  int thresh;
+  if (!getRangeValue(value, 0, 255, thresh))
+    return -1;
+  ARHandleLock lock(self);
+  return checkSetResult(arSetLabelingThresh(self->handle, thresh));
+}
+
+// get pattern detection mode
+PyObject * PyARHandle_getPatternDetectionMode(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return PyLong_FromLong(self->handle->arPatternDetectionMode);
+}
+
+// set pattern detection mode
+int PyARHandle_setPatternDetectionMode(PyARHandle * self, PyObject *value, void *closure)
+{
+  int mode;
+  if (!getRangeValue(value, AR_TEMPLATE_MATCHING_COLOR, AR_TEMPLATE_MATCHING_MONO_AND_MATRIX, mode))
+    return -1;
+  ARHandleLock lock(self);
+  return checkSetResult(arSetPatternDetectionMode(self->handle, mode));
 }
 
 // get attached pattern handle
@@ -114,6 +331,9 @@ int PyARHandle_setAttachPatt (PyARHandle * self, PyObject *value, void *closure)
     return -1;
   }
 
+  // lock handle, so pattern handle isn't changed during detection
+  ARHandleLock lock(self);
+
   // if value is null, detach pattern handle
   if (value == NULL)
   {
@@ -142,22 +362,12 @@ PyObject * PyARHandle_getMarkers(PyARHandle * self, void * closure)
   // check if markers should be updated
   if (self->updateMarkers)
   {
+    // release previous tuple, so it can be reused by pool
+    *self->markers = PyObjectOwner();
+    PyObjectOwner pyMarkers(self->markerPool->getMarkers(self->markerInfo, self->markerNum, self->markerTime));
+    if (pyMarkers.isNull())
+      return nullptr;
     self->updateMarkers = false;
-    // create new tuple of markers
-    size_t markerCount = arGetMarkerNum(self->handle);
-    PyObjectOwner pyMarkers (PyTuple_New(markerCount));
-    // get marker data
-    if (markerCount > 0)
-    {
-      ARMarkerInfo * markers = arGetMarker(self->handle);
-      for (size_t i = 0; i < markerCount; ++i)
-      {
-        PyARMarkerInfo * pyMarker = PyObject_New(PyARMarkerInfo, &ARMarkerInfoType);
-        pyMarker->marker = &markers[i];
-        PyTuple_SetItem(pyMarkers.get(), i, getPyObject(pyMarker));
-      }
-    }
-    // set new tuple
     *self->markers = pyMarkers;
   }
 
@@ -165,46 +375,796 @@ PyObject * PyARHandle_getMarkers(PyARHandle * self, void * closure)
   return self->markers->returnValue();
 }
 
+// get buffer with records of detected markers
+PyObject * PyARHandle_getMarkerArray(PyARHandle * self, void * closure)
+{
+  // check if marker array should be updated
+  if (self->updateMarkerArray)
+  {
+    if (!updateMarkerArray(*self->markerArray, self->markerInfo, self->markerNum))
+      return NULL;
+    self->updateMarkerArray = false;
+  }
+
+  // return marker array
+  return self->markerArray->returnValue();
+}
+
+
+// set pixel format of ARToolKit handle for given settings, handle fields are changed only if it succeeds
+static bool applyPixelFormat(PyARHandle * self, AR_PIXEL_FORMAT pixelFormat, bool lumaConversion, bool bottomOrigin)
+{
+  // bottom-up rows are read by luminance conversion with negative pitch, so they aren't copied first
+  bool convert = pixelFormat != AR_PIXEL_FORMAT_MONO
+    && ((lumaConversion && !isLumaFormat(pixelFormat)) || bottomOrigin);
+  if (arSetPixelFormat(self->handle, convert ? AR_PIXEL_FORMAT_MONO : pixelFormat) < 0)
+    return false;
+  self->pixelFormat = pixelFormat;
+  self->lumaConversion = lumaConversion;
+  self->bottomOrigin = bottomOrigin;
+  return true;
+}
+
+// compute fingerprint of settings affecting detection
+static unsigned long long getSettingsFingerprint(PyARHandle * self, ptrdiff_t pitch)
+{
+  const ARHandle * handle = self->handle;
+  unsigned long long values[] = { (unsigned long long)handle->arPixelFormat, (unsigned long long)handle->arImageProcMode,
+    (unsigned long long)handle->arLabelingMode, (unsigned long long)handle->arLabelingThreshMode,
+    // automatic threshold is derived from image
+    (unsigned long long)(handle->arLabelingThreshMode == AR_LABELING_THRESH_MODE_MANUAL ? handle->arLabelingThresh : -1),
+    (unsigned long long)handle->arPatternDetectionMode, (unsigned long long)handle->matrixCodeType,
+    (unsigned long long)(handle->pattHandle != nullptr ? handle->pattHandle->patt_num : -1),
+    (unsigned long long)(size_t)handle->pattHandle, (unsigned long long)(handle->pattRatio * 1e9),
+    (unsigned long long)self->pyramid->levels, (unsigned long long)self->regionTracker->enabled,
+    (unsigned long long)self->tiles->enabled,
+    (unsigned long long)pitch };
+  return computeFingerprint(reinterpret_cast<const ARUint8*>(values), 0, sizeof(values), 1, 0);
+}
+
+// detect markers in image data, called with locked handle and without interpreter lock
+bool detectMarkers(PyARHandle * self, ARUint8 * image, ptrdiff_t pitch)
+{
+  const int xsize = self->handle->xsize, ysize = self->handle->ysize;
+  // markers of the last detection are kept for identical image
+  unsigned long long fingerprint = 0;
+  self->frameSkipped = false;
+  if (self->frameSkipping)
+  {
+    const size_t rowSize = size_t(xsize) * arUtilGetPixelSize(self->pixelFormat);
+    fingerprint = computeFingerprint(image, pitch, rowSize, ysize, getSettingsFingerprint(self, pitch));
+    if (fingerprint == self->frameFingerprint)
+    {
+      ++self->fingerprintHits;
+      self->frameSkipped = true;
+      return true;
+    }
+    ++self->fingerprintMisses;
+    self->frameFingerprint = 0;
+  }
+  // convert image to luminance plane, if ARToolKit handle detects in MONO format, rows are read with their pitch
+  if (self->handle->arPixelFormat != self->pixelFormat)
+  {
+    ARUint8 * luma = self->lumaBuffer->get(size_t(xsize) * ysize);
+    convertToLuma(image, luma, xsize, ysize, self->pixelFormat, pitch);
+    image = luma;
+    ++self->convertedImages;
+  }
+  // ARToolKit requires packed rows
+  else if (pitch != 0)
+  {
+    const size_t rowSize = size_t(xsize) * arUtilGetPixelSize(self->pixelFormat);
+    ARUint8 * packed = self->packBuffer->get(rowSize * ysize);
+    packRows(image, pitch, packed, rowSize, ysize);
+    image = packed;
+    ++self->repackedImages;
+  }
+  else
+    ++self->directImages;
+  // detect in regions of previously detected markers
+  bool result = self->regionTracker->enabled && self->regionTracker->detectRegions(self->handle, image);
+  // detect in changed tiles of image or in full image, coarse to fine when pyramid is enabled
+  if (!result)
+  {
+    if (self->tiles->enabled)
+      result = self->tiles->detect(self->handle, image);
+    else
+      result = self->pyramid->levels > 0 ? self->pyramid->detect(self->handle, image)
+        : arDetectMarker(self->handle, image) >= 0;
+    if (result && self->regionTracker->enabled)
+      self->regionTracker->fullScanDone(self->handle);
+  }
+  if (result)
+    self->frameFingerprint = fingerprint;
+  return result;
+}
+
+// publish markers of last detection, called with locked handle and interpreter lock
+void publishMarkers(PyARHandle * self, double timestamp)
+{
+  self->markerTime = timestamp;
+  self->detectionLatency = getClockTime() - timestamp;
+  // copy markers from handle, so next detection can't change them
+  self->markerNum = arGetMarkerNum(self->handle);
+  if (self->markerNum > 0)
+    std::copy(arGetMarker(self->handle), arGetMarker(self->handle) + self->markerNum, self->markerInfo);
+  // set flags to update markers
+  self->updateMarkers = true;
+  self->updateMarkerArray = true;
+}
+
+// get size of image data
+size_t getImageSize(PyARHandle * self)
+{
+  return self->handle->xsize * self->handle->ysize * arUtilGetPixelSize(self->pixelFormat);
+}
+
+// get optional layout of image rows from arguments, pitch defaults to packed rows
+static bool getRowLayoutArgs(PyObject * pitchArg, PyObject * offsetArg, bool & layout, Py_ssize_t & pitch,
+  Py_ssize_t & offset)
+{
+  layout = pitchArg != Py_None || offsetArg != Py_None;
+  pitch = 0;
+  offset = 0;
+  if (pitchArg != Py_None && (pitch = PyLong_AsSsize_t(pitchArg)) == -1 && PyErr_Occurred())
+    return false;
+  if (offsetArg != Py_None && (offset = PyLong_AsSsize_t(offsetArg)) == -1 && PyErr_Occurred())
+    return false;
+  if (offset < 0)
+  {
+    PyErr_SetString(PyExc_ValueError, "Offset of image data can't be negative");
+    return false;
+  }
+  return true;
+}
+
+// bind image buffer to slot with optional layout of rows, null if image doesn't match handle
+ImageBufferHolder * getImageBuffer(PyARHandle * self, PyObject * image, ImageBufferSlot & slot, bool layout,
+  ptrdiff_t pitch, size_t offset)
+{
+  // planes of planar YUV image may be passed as tuple, markers are detected in luminance plane
+  const bool planar = isLumaFormat(self->pixelFormat) && self->pixelFormat != AR_PIXEL_FORMAT_MONO;
+  if (planar && PyTuple_Check(image))
+  {
+    if (PyTuple_GET_SIZE(image) == 0)
+    {
+      slot.release();
+      return nullptr;
+    }
+    image = PyTuple_GET_ITEM(image, 0);
+  }
+  ImageBufferHolder * imageBuff = slot.bind(image);
+  if (imageBuff == nullptr)
+    return nullptr;
+  const size_t rows = size_t(self->handle->ysize);
+  const size_t rowSize = size_t(self->handle->xsize) * arUtilGetPixelSize(self->pixelFormat);
+  bool valid = true;
+  if (layout)
+    valid = imageBuff->setRowLayout(offset, pitch != 0 ? pitch : ptrdiff_t(rowSize), rowSize, rows);
+  // chroma planes following luminance plane aren't used
+  else if (planar && imageBuff->getSize() > rowSize * rows)
+    valid = imageBuff->cropRows(rowSize, rows);
+  valid = valid && imageBuff->isValid(getImageSize(self), rows);
+  // bottom-up rows are read with negative pitch, so they aren't flipped by copy
+  if (valid && self->bottomOrigin)
+    valid = imageBuff->flipRows(rows);
+  if (!valid)
+  {
+    slot.release();
+    return nullptr;
+  }
+  return imageBuff;
+}
+
 // detect markers in image data
-PyObject * PyARHandle_detect(PyARHandle * self, PyObject * args)
+PyObject * PyARHandle_detect(PyARHandle * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames)
 {
-  // get image data
-  PyObject * image;
-  if (!PyArg_ParseTuple(args, "O", &image))
-    Py_RETURN_FALSE;
+  // get image data with its capture time
+  static const char * const names[] = { "image", "timestamp", "pitch", "offset" };
+  PyObject * values[] = { nullptr, Py_None, Py_None, Py_None };
+  double timestamp;
+  bool layout;
+  Py_ssize_t pitch, offset;
+  if (!unpackFastArgs("detect", args, nargs, kwnames, names, 1, values) || !getTimestamp(values[1], timestamp)
+    || !getRowLayoutArgs(values[2], values[3], layout, pitch, offset))
+    return NULL;
+  PyObject * image = values[0];
 
-  // get image buffer holder
-  auto imageBuff = getBufferHolder(image);
-  if (!imageBuff || !imageBuff->isValid(self->handle->xsize * self->handle->ysize * self->handle->arPixelSize))
+  // lock handle before image buffer is checked, so its size can't change until detection ends
+  ARHandleLock lock(self);
+  ImageBufferSlot imageSlot;
+  ImageBufferHolder * imageBuff = getImageBuffer(self, image, imageSlot, layout, pitch, size_t(offset));
+  if (imageBuff == nullptr)
     Py_RETURN_FALSE;
 
-  // process image data to detect markers
-  if (arDetectMarker(self->handle, imageBuff->getData()) < 0)
+  // process image data to detect markers, image buffer is held by its holder,
+  // so interpreter lock can be released for the time of detection
+  PyAllowThreads allowThreads;
+  bool result = detectMarkers(self, imageBuff->getData(), imageBuff->getPitch());
+  // take interpreter lock back to publish markers
+  allowThreads.restore();
+  if (!result)
     Py_RETURN_FALSE;
-  // set flag to update markers
-  self->updateMarkers = true;
+  // markers of skipped image keep capture time of the image they were detected in
+  if (!self->frameSkipped)
+    publishMarkers(self, timestamp);
 
   Py_RETURN_TRUE;
 }
 
+// start background tracking thread
+PyObject * PyARHandle_startTracking(PyARHandle * self)
+{
+  if (self->handle == nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Handle isn't initialized");
+    return NULL;
+  }
+  if (self->tracking == nullptr)
+  {
+    self->tracking = new TrackingThread(self, getImageSize(self));
+    self->polledSequence = 0;
+  }
+  Py_RETURN_NONE;
+}
+
+// stop background tracking thread
+PyObject * PyARHandle_stopTracking(PyARHandle * self)
+{
+  TrackingThread * tracking = self->tracking;
+  self->tracking = nullptr;
+  if (tracking != nullptr)
+  {
+    // worker may wait for handle locked by thread waiting for interpreter lock
+    PyAllowThreads allowThreads;
+    delete tracking;
+  }
+  Py_RETURN_NONE;
+}
+
+// check if tracking thread is running
+PyObject * PyARHandle_getTracking(PyARHandle * self, void * closure)
+{
+  return PyBool_FromLong(self->tracking != nullptr);
+}
+
+// get number of frames dropped by tracking thread
+PyObject * PyARHandle_getDroppedFrames(PyARHandle * self, void * closure)
+{
+  return PyLong_FromUnsignedLongLong(self->tracking != nullptr ? self->tracking->getDroppedFrames() : 0);
+}
+
+// submit image data to tracking thread
+PyObject * PyARHandle_submit(PyARHandle * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames)
+{
+  // get image data with its capture time
+  static const char * const names[] = { "image", "timestamp", "pitch", "offset" };
+  PyObject * values[] = { nullptr, Py_None, Py_None, Py_None };
+  double timestamp;
+  bool layout;
+  Py_ssize_t pitch, offset;
+  if (!unpackFastArgs("submit", args, nargs, kwnames, names, 1, values) || !getTimestamp(values[1], timestamp)
+    || !getRowLayoutArgs(values[2], values[3], layout, pitch, offset))
+    return NULL;
+  PyObject * image = values[0];
+  if (self->tracking == nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Tracking isn't running");
+    return NULL;
+  }
+
+  // get image buffer holder
+  ImageBufferSlot imageSlot;
+  ImageBufferHolder * imageBuff = getImageBuffer(self, image, imageSlot, layout, pitch, size_t(offset));
+  if (imageBuff == nullptr)
+    return PyLong_FromLong(0);
+
+  // copy image rows to tracking thread and return its sequence number, 0 if size of frames was changed meanwhile
+  size_t rows = size_t(self->handle->ysize);
+  return PyLong_FromUnsignedLongLong(self->tracking->submit(imageBuff->getData(), imageBuff->getSize() / rows,
+    rows, imageBuff->getPitch(), timestamp));
+}
+
+// get the most recent result of tracking thread
+PyObject * PyARHandle_poll(PyARHandle * self)
+{
+  if (self->tracking == nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Tracking isn't running");
+    return NULL;
+  }
+
+  // publish markers of new result
+  double timestamp;
+  unsigned long long sequence = self->tracking->getResult(self->polledSequence, self->markerInfo, self->markerNum,
+    timestamp);
+  if (sequence > self->polledSequence)
+  {
+    self->polledSequence = sequence;
+    self->markerTime = timestamp;
+    self->detectionLatency = getClockTime() - timestamp;
+    self->updateMarkers = true;
+    self->updateMarkerArray = true;
+  }
+
+  // return sequence number with markers
+  PyObjectOwner markers(PyARHandle_getMarkers(self, nullptr));
+  return Py_BuildValue("(KO)", sequence, markers.get());
+}
+
+// copy detection settings and attached pattern handle to new handle
+static void copyHandleSettings(ARHandle * source, ARHandle * target)
+{
+  arSetPixelFormat(target, source->arPixelFormat);
+  arSetImageProcMode(target, source->arImageProcMode);
+  arSetLabelingMode(target, source->arLabelingMode);
+  arSetLabelingThreshMode(target, source->arLabelingThreshMode);
+  arSetLabelingThresh(target, source->arLabelingThresh);
+  arSetPatternDetectionMode(target, source->arPatternDetectionMode);
+  arSetPattRatio(target, source->pattRatio);
+  arSetMatrixCodeType(target, source->matrixCodeType);
+  if (source->pattHandle != nullptr)
+    arPattAttach(target, source->pattHandle);
+}
+
+// change image size or pixel format of handle
+PyObject * PyARHandle_reconfigure(PyARHandle * self, PyObject * args, PyObject * kwds)
+{
+  // get arguments
+  PyObject * sizeArg = Py_None;
+  PyObject * pixFmtArg = Py_None;
+  const char * lookupTable = nullptr;
+  static char *kwlist[] = { "size", "pixelFormat", "lookupTable", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|OOz", kwlist, &sizeArg, &pixFmtArg, &lookupTable))
+    return NULL;
+  if (self->handle == nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Handle isn't initialized");
+    return NULL;
+  }
+  int xsize = self->handle->xsize;
+  int ysize = self->handle->ysize;
+  if (sizeArg != Py_None && !PyArg_ParseTuple(sizeArg, "ii", &xsize, &ysize))
+    return NULL;
+  if (xsize <= 0 || ysize <= 0)
+  {
+    PyErr_SetString(PyExc_ValueError, "Image size has to be positive");
+    return NULL;
+  }
+  int pixFmt = self->pixelFormat;
+  if (pixFmtArg != Py_None && !getRangeValue(pixFmtArg, AR_PIXEL_FORMAT_INVALID + 1, AR_PIXEL_FORMAT_MAX, pixFmt))
+    return NULL;
+
+  // parameters of new size, lookup table is shared, so it isn't changed
+  bool resize = xsize != self->handle->xsize || ysize != self->handle->ysize;
+  ARParam param;
+  if (resize && arParamChangeSize(&self->paramLT->param, xsize, ysize, &param) < 0)
+  {
+    PyErr_SetString(PyExc_ValueError, "Parameters can't be changed to image size");
+    return NULL;
+  }
+
+  // ARToolKit handle can't be resized, new one is created with cached lookup table without lock of handle
+  const char * error = nullptr;
+  ARParamLT * paramLT = nullptr;
+  ARHandle * handle = nullptr;
+  if (resize)
+  {
+    PyAllowThreads allowThreads;
+    paramLT = ParamLTCache::getInstance().acquire(param, AR_PARAM_LT_DEFAULT_OFFSET, lookupTable);
+    handle = paramLT != nullptr ? arCreateHandle(paramLT) : nullptr;
+    if (handle == nullptr)
+    {
+      ParamLTCache::getInstance().release(paramLT);
+      error = "Handle of new size can't be created";
+    }
+  }
+
+  // lock handle, so tracking thread doesn't use it during change, fields are changed
+  // while holding interpreter lock too, so they can be read under any of both locks
+  ARHandleLock lock(self);
+  if (handle != nullptr)
+  {
+    copyHandleSettings(self->handle, handle);
+    arPattDetach(self->handle);
+    arDeleteHandle(self->handle);
+    ParamLTCache::getInstance().release(self->paramLT);
+    self->handle = handle;
+    self->paramLT = paramLT;
+  }
+  if (error == nullptr && !applyPixelFormat(self, AR_PIXEL_FORMAT(pixFmt), self->lumaConversion, self->bottomOrigin))
+    error = "Pixel format can't be set";
+  // regions and markers of previous images aren't valid, other buffers are resized on demand
+  self->regionTracker->reset();
+  self->tiles->reset();
+  self->frameFingerprint = 0;
+  if (self->tracking != nullptr)
+    self->tracking->resize(getImageSize(self));
+
+  if (error != nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, error);
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+
+// get time from capture of image to publishing of its markers
+PyObject * PyARHandle_getDetectionLatency(PyARHandle * self, void * closure)
+{
+  return PyFloat_FromDouble(self->detectionLatency);
+}
+
+
+// check if region of interest tracking is enabled
+PyObject * PyARHandle_getRoiTracking(PyARHandle * self, void * closure)
+{
+  return PyBool_FromLong(self->regionTracker->enabled);
+}
+
+// enable region of interest tracking
+int PyARHandle_setRoiTracking(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  if (value == NULL || !PyBool_Check(value))
+  {
+    PyErr_SetString(PyExc_TypeError, "Value has to be bool");
+    return -1;
+  }
+  // set new value, next detection scans full image
+  ARHandleLock lock(self);
+  if (!checkThreshMode(self->handle->arLabelingThreshMode, value == Py_True))
+    return -1;
+  self->regionTracker->enabled = value == Py_True;
+  self->regionTracker->reset();
+  return 0;
+}
+
+// get padding of search regions
+PyObject * PyARHandle_getRoiPadding(PyARHandle * self, void * closure)
+{
+  return PyFloat_FromDouble(self->regionTracker->padding);
+}
+
+// set padding of search regions
+int PyARHandle_setRoiPadding(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  double padding = value != NULL ? PyFloat_AsDouble(value) : -1.0;
+  if (padding < 0.0)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be non-negative number");
+    return -1;
+  }
+  // set new value
+  ARHandleLock lock(self);
+  self->regionTracker->padding = padding;
+  return 0;
+}
+
+// get interval of full image scans
+PyObject * PyARHandle_getRoiFullScanInterval(PyARHandle * self, void * closure)
+{
+  return PyLong_FromLong(self->regionTracker->fullScanInterval);
+}
+
+// set interval of full image scans
+int PyARHandle_setRoiFullScanInterval(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  long interval = value != NULL && PyLong_Check(value) ? PyLong_AsLong(value) : 0;
+  if (interval < 1)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be positive integer");
+    return -1;
+  }
+  // set new value
+  ARHandleLock lock(self);
+  self->regionTracker->fullScanInterval = int(interval);
+  return 0;
+}
+
+// get statistics of region of interest tracking
+PyObject * PyARHandle_getRoiStats(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return Py_BuildValue("{sKsK}", "full", self->regionTracker->fullScans,
+    "region", self->regionTracker->regionScans);
+}
+
+// get statistics of image ingestion
+PyObject * PyARHandle_getIngestStats(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return Py_BuildValue("{sKsKsK}", "direct", self->directImages, "converted", self->convertedImages,
+    "repacked", self->repackedImages);
+}
+
+// get flag of incremental detection
+PyObject * PyARHandle_getTileDetection(PyARHandle * self, void * closure)
+{
+  return PyBool_FromLong(self->tiles->enabled);
+}
+
+// enable incremental detection
+int PyARHandle_setTileDetection(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  if (value == NULL || !PyBool_Check(value))
+  {
+    PyErr_SetString(PyExc_TypeError, "Value has to be bool");
+    return -1;
+  }
+  // set new value, next detection scans full image
+  ARHandleLock lock(self);
+  if (!checkThreshMode(self->handle->arLabelingThreshMode, value == Py_True))
+    return -1;
+  self->tiles->enabled = value == Py_True;
+  self->tiles->reset();
+  return 0;
+}
+
+// get size of tiles
+PyObject * PyARHandle_getTileSize(PyARHandle * self, void * closure)
+{
+  return PyLong_FromLong(self->tiles->tileSize);
+}
+
+// set size of tiles
+int PyARHandle_setTileSize(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value, size is even to keep regions aligned
+  int size;
+  if (!getRangeValue(value, TileDetector::minTileSize, TileDetector::maxTileSize, size))
+    return -1;
+  if (size % 2 != 0)
+  {
+    PyErr_SetString(PyExc_ValueError, "Value has to be even");
+    return -1;
+  }
+  // set new value, next detection scans full image
+  ARHandleLock lock(self);
+  self->tiles->tileSize = size;
+  self->tiles->reset();
+  return 0;
+}
+
+// get threshold of changed tiles
+PyObject * PyARHandle_getTileThreshold(PyARHandle * self, void * closure)
+{
+  return PyFloat_FromDouble(self->tiles->threshold);
+}
+
+// set threshold of changed tiles
+int PyARHandle_setTileThreshold(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  double threshold = value != NULL ? PyFloat_AsDouble(value) : -1.0;
+  if (threshold < 0.0)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be non-negative number");
+    return -1;
+  }
+  // set new value
+  ARHandleLock lock(self);
+  self->tiles->threshold = threshold;
+  return 0;
+}
+
+// get interval of full image scans of incremental detection
+PyObject * PyARHandle_getTileFullScanInterval(PyARHandle * self, void * closure)
+{
+  return PyLong_FromLong(self->tiles->fullScanInterval);
+}
+
+// set interval of full image scans of incremental detection
+int PyARHandle_setTileFullScanInterval(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  long interval = value != NULL && PyLong_Check(value) ? PyLong_AsLong(value) : 0;
+  if (interval < 1)
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, "Value has to be positive integer");
+    return -1;
+  }
+  // set new value
+  ARHandleLock lock(self);
+  self->tiles->fullScanInterval = int(interval);
+  return 0;
+}
+
+// get statistics of incremental detection
+PyObject * PyARHandle_getTileStats(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return Py_BuildValue("{sKsKsKsK}", "full", self->tiles->fullScans, "incremental", self->tiles->incrementalScans,
+    "tiles", self->tiles->comparedTiles, "changed", self->tiles->changedTiles);
+}
+
+// get flag of skipping of identical images
+PyObject * PyARHandle_getFrameSkipping(PyARHandle * self, void * closure)
+{
+  return PyBool_FromLong(self->frameSkipping);
+}
+
+// set flag of skipping of identical images
+int PyARHandle_setFrameSkipping(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  int skipping = value != NULL ? PyObject_IsTrue(value) : -1;
+  if (skipping < 0)
+  {
+    PyErr_SetString(PyExc_TypeError, "Value has to be boolean");
+    return -1;
+  }
+  // set new value, the next image is always detected
+  ARHandleLock lock(self);
+  self->frameSkipping = skipping != 0;
+  self->frameFingerprint = 0;
+  return 0;
+}
+
+// get statistics of skipping of identical images
+PyObject * PyARHandle_getFrameSkipStats(PyARHandle * self, void * closure)
+{
+  ARHandleLock lock(self);
+  return Py_BuildValue("{sKsK}", "hits", self->fingerprintHits, "misses", self->fingerprintMisses);
+}
+
+// get number of pyramid levels
+PyObject * PyARHandle_getPyramidLevel(PyARHandle * self, void * closure)
+{
+  return PyLong_FromLong(self->pyramid->levels);
+}
+
+// set number of pyramid levels
+int PyARHandle_setPyramidLevel(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  int levels;
+  if (!getRangeValue(value, 0, PyramidDetector::maxLevels, levels))
+    return -1;
+  // set new value
+  ARHandleLock lock(self);
+  if (!checkThreshMode(self->handle->arLabelingThreshMode, levels > 0))
+    return -1;
+  self->pyramid->levels = levels;
+  return 0;
+}
+
+// get flag of luminance conversion
+PyObject * PyARHandle_getLumaConversion(PyARHandle * self, void * closure)
+{
+  return PyBool_FromLong(self->lumaConversion);
+}
+
+// set flag of luminance conversion
+int PyARHandle_setLumaConversion(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  int convert = value != NULL ? PyObject_IsTrue(value) : -1;
+  if (convert < 0)
+  {
+    PyErr_SetString(PyExc_TypeError, "Value has to be boolean");
+    return -1;
+  }
+  // set new value, ARToolKit handle switches pixel format
+  ARHandleLock lock(self);
+  return checkSetResult(applyPixelFormat(self, self->pixelFormat, convert != 0, self->bottomOrigin) ? 0 : -1);
+}
+
+// get origin of image rows
+PyObject * PyARHandle_getOrigin(PyARHandle * self, void * closure)
+{
+  return PyUnicode_FromString(self->bottomOrigin ? "bottom" : "top");
+}
+
+// set origin of image rows
+int PyARHandle_setOrigin(PyARHandle * self, PyObject *value, void *closure)
+{
+  // check value
+  if (value == nullptr || !PyUnicode_Check(value))
+  {
+    PyErr_SetString(PyExc_TypeError, "Value has to be string");
+    return -1;
+  }
+  bool bottom = PyUnicode_CompareWithASCIIString(value, "bottom") == 0;
+  if (!bottom && PyUnicode_CompareWithASCIIString(value, "top") != 0)
+  {
+    PyErr_SetString(PyExc_ValueError, "Origin has to be 'top' or 'bottom'");
+    return -1;
+  }
+  // set new value, ARToolKit handle switches pixel format
+  ARHandleLock lock(self);
+  return checkSetResult(applyPixelFormat(self, self->pixelFormat, self->lumaConversion, bottom) ? 0 : -1);
+}
+
 
 // members descriptions
 PyGetSetDef PyARHandle_getseters[] =
 {
   { "pixelFormat", (getter)PyARHandle_getPixelFormat, NULL,
   "pixel format", NULL },
+  { "size", (getter)PyARHandle_getSize, NULL,
+  "image size, it's changed by reconfigure", NULL },
+  { "imageProcMode", (getter)PyARHandle_getImageProcMode, (setter)PyARHandle_setImageProcMode,
+  "image processing mode, ARImageProcMode value", NULL },
+  { "labelingMode", (getter)PyARHandle_getLabelingMode, (setter)PyARHandle_setLabelingMode,
+  "labeling mode, ARLabelingMode value", NULL },
+  { "borderSize", (getter)PyARHandle_getBorderSize, (setter)PyARHandle_setBorderSize,
+  "border size of markers relative to marker width", NULL },
+  { "labelingThreshMode", (getter)PyARHandle_getLabelingThreshMode, (setter)PyARHandle_setLabelingThreshMode,
+  "labeling threshold mode, ARLabelingThreshMode value", NULL },
+  { "labelingThresh", (getter)PyARHandle_getLabelingThresh, (setter)PyARHandle_setLabelingThresh,
+  "labeling threshold from 0 to 255", NULL },
+  { "patternDetectionMode", (getter)PyARHandle_getPatternDetectionMode, (setter)PyARHandle_setPatternDetectionMode,
+  "pattern detection mode, ARPatternDetectionMode value", NULL },
   { "attachPatt", (getter)PyARHandle_getAttachPatt, (setter)PyARHandle_setAttachPatt,
   "attached pattern handle", NULL },
   { "markers", (getter)PyARHandle_getMarkers, NULL,
   "list of detected markers", NULL },
+  { "markerArray", (getter)PyARHandle_getMarkerArray, NULL,
+  "buffer with record of id, area, dir, cf, pos, vertex and line for every detected marker", NULL },
+  { "tracking", (getter)PyARHandle_getTracking, NULL,
+  "true, if background tracking thread is running", NULL },
+  { "droppedFrames", (getter)PyARHandle_getDroppedFrames, NULL,
+  "number of submitted frames dropped by tracking thread", NULL },
+  { "detectionLatency", (getter)PyARHandle_getDetectionLatency, NULL,
+  "time in seconds from capture of image to publishing of its markers", NULL },
+  { "roiTracking", (getter)PyARHandle_getRoiTracking, (setter)PyARHandle_setRoiTracking,
+  "detect markers only in regions around markers of previous frame", NULL },
+  { "roiPadding", (getter)PyARHandle_getRoiPadding, (setter)PyARHandle_setRoiPadding,
+  "padding of search regions relative to marker size", NULL },
+  { "roiFullScanInterval", (getter)PyARHandle_getRoiFullScanInterval, (setter)PyARHandle_setRoiFullScanInterval,
+  "maximal number of frames between full image scans", NULL },
+  { "roiStats", (getter)PyARHandle_getRoiStats, NULL,
+  "dictionary with numbers of full and region scans", NULL },
+  { "tileDetection", (getter)PyARHandle_getTileDetection, (setter)PyARHandle_setTileDetection,
+  "label only changed tiles of image and their neighbours, reuse squares of unchanged tiles, "
+  "confidence cutoff and tracking history are applied only by periodic full scans", NULL },
+  { "tileSize", (getter)PyARHandle_getTileSize, (setter)PyARHandle_setTileSize,
+  "even size of tiles of incremental detection in pixels", NULL },
+  { "tileThreshold", (getter)PyARHandle_getTileThreshold, (setter)PyARHandle_setTileThreshold,
+  "mean absolute difference of tile bytes, above which tile is changed", NULL },
+  { "tileFullScanInterval", (getter)PyARHandle_getTileFullScanInterval, (setter)PyARHandle_setTileFullScanInterval,
+  "maximal number of frames between full image scans of incremental detection", NULL },
+  { "tileStats", (getter)PyARHandle_getTileStats, NULL,
+  "dictionary with numbers of full and incremental scans, compared and changed tiles", NULL },
+  { "pyramidLevel", (getter)PyARHandle_getPyramidLevel, (setter)PyARHandle_setPyramidLevel,
+  "number of halvings of image for coarse to fine detection, 0 disables it", NULL },
+  { "lumaConversion", (getter)PyARHandle_getLumaConversion, (setter)PyARHandle_setLumaConversion,
+  "convert color images to luminance by SIMD kernels and detect in MONO format", NULL },
+  { "origin", (getter)PyARHandle_getOrigin, (setter)PyARHandle_setOrigin,
+  "origin of image rows, 'top' or 'bottom' for images read from OpenGL, bottom-up images are detected in luminance plane", NULL },
+  { "frameSkipping", (getter)PyARHandle_getFrameSkipping, (setter)PyARHandle_setFrameSkipping,
+  "skip detection of image identical to the last detected one by its fingerprint and keep its markers", NULL },
+  { "frameSkipStats", (getter)PyARHandle_getFrameSkipStats, NULL,
+  "dictionary with numbers of images skipped by matching fingerprint (hits) and detected (misses)", NULL },
+  { "ingestStats", (getter)PyARHandle_getIngestStats, NULL,
+  "dictionary with numbers of images detected in place, converted to luminance and repacked from strided rows", NULL },
   { NULL }  /* Sentinel */
 };
 
 /// methods descriptions
 PyMethodDef PyARHandle_methods[] =
 {
-  { "detect", (PyCFunction)PyARHandle_detect, METH_VARARGS,
-  "Detects markers in image data, return true, if successful" },
+  { "detect", PY_FASTCALL_METHOD(PyARHandle, PyARHandle_detect),
+  "Detects markers in image data with optional capture time in seconds and optional pitch and offset of rows in bytes, return true, if successful" },
+  { "startTracking", (PyCFunction)PyARHandle_startTracking, METH_NOARGS,
+  "Starts background tracking thread" },
+  { "stopTracking", (PyCFunction)PyARHandle_stopTracking, METH_NOARGS,
+  "Stops background tracking thread" },
+  { "submit", PY_FASTCALL_METHOD(PyARHandle, PyARHandle_submit),
+  "Submits image data with optional capture time and optional pitch and offset of rows to tracking thread, return sequence number of frame or 0, if image is invalid" },
+  { "poll", (PyCFunction)PyARHandle_poll, METH_NOARGS,
+  "Returns tuple of sequence number of frame and markers from the most recent tracking result" },
+  { "reconfigure", (PyCFunction)PyARHandle_reconfigure, METH_VARARGS | METH_KEYWORDS,
+  "Changes image size and pixel format keeping detection settings and attached pattern handle" },
   { NULL }  /* Sentinel */
 };
 
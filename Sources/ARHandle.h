@@ -23,17 +23,28 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <AR/ar.h>
 #include <Python.h>
+#include <memory>
+#include <mutex>
 
 #include "PyObjectHelper.h"
 
 namespace ARTKBlender
 {
 
+class TrackingThread;
+class RegionTracker;
+class PyramidDetector;
+class TileDetector;
+class ARMarkerInfoPool;
+class AlignedBuffer;
+class ImageBufferHolder;
+class ImageBufferSlot;
+
 /// python data structure for ARHandle
 struct PyARHandle
 {
   PyObject_HEAD
-  /// ARHandle structure
+  /// ARHandle structure, it's replaced only while holding both its lock and interpreter lock
   ARHandle * handle;
   /// lookup table from ARParam
   ARParamLT * paramLT;
@@ -41,11 +52,118 @@ struct PyARHandle
   PyObjectOwner * attachPatt;
   /// list of detected markers
   PyObjectOwner * markers;
+  /// pool of marker objects reused by markers lists
+  ARMarkerInfoPool * markerPool;
   /// flag to update markers - true, if new detection was performed
   bool updateMarkers;
+  /// buffer with records of detected markers
+  PyObjectOwner * markerArray;
+  /// flag to update marker array - true, if new detection was performed
+  bool updateMarkerArray;
+  /// lock of ARHandle structure, it's acquired only with released interpreter lock
+  std::mutex * lock;
+  /// markers published by last detection, python marker objects refer to them
+  ARMarkerInfo * markerInfo;
+  /// number of published markers
+  int markerNum;
+  /// capture time of image with published markers in seconds
+  double markerTime;
+  /// time in seconds from capture of image to publishing of its markers
+  double detectionLatency;
+  /// background tracking thread, null if tracking isn't running
+  TrackingThread * tracking;
+  /// sequence number of frame of the last polled tracking result
+  unsigned long long polledSequence;
+  /// region of interest tracking
+  RegionTracker * regionTracker;
+  /// coarse to fine detector
+  PyramidDetector * pyramid;
+  /// incremental detector of changed tiles
+  TileDetector * tiles;
+  /// pixel format of image data passed to handle
+  AR_PIXEL_FORMAT pixelFormat;
+  /// image data are converted to luminance plane and ARToolKit handle detects in MONO format
+  bool lumaConversion;
+  /// rows of image data are stored bottom-up, as OpenGL reads them, they are read by luminance conversion
+  bool bottomOrigin;
+  /// luminance plane of converted image data
+  AlignedBuffer * lumaBuffer;
+  /// packed copy of image data with row pitch
+  AlignedBuffer * packBuffer;
+  /// number of images detected in place
+  unsigned long long directImages;
+  /// number of images read by luminance conversion
+  unsigned long long convertedImages;
+  /// number of images with row pitch copied to packed buffer
+  unsigned long long repackedImages;
+  /// skip detection of images identical to the last detected one
+  bool frameSkipping;
+  /// fingerprint of the last detected image with handle settings, 0 if there is none
+  unsigned long long frameFingerprint;
+  /// the last image was skipped, markers and their capture time are kept from the previous one
+  bool frameSkipped;
+  /// number of images skipped by matching fingerprint
+  unsigned long long fingerprintHits;
+  /// number of images detected after fingerprint mismatch
+  unsigned long long fingerprintMisses;
+};
+
+/**
+    Lock of handle, it's acquired with released interpreter lock, so it can't
+    deadlock with thread holding the handle and waiting for interpreter lock.
+    Interpreter lock is held again, when constructor returns.
+*/
+class ARHandleLock : public PyMutexLock
+{
+public:
+  /**
+      Constructor locks handle.
+      \param handle handle to lock
+  */
+  ARHandleLock (PyARHandle * handle) : PyMutexLock(*handle->lock)
+  {}
 };
 
 // declaration of python module type
 extern PyTypeObject ARHandleType;
 
+/**
+    Provides size of image data required by handle.
+    \param self handle object
+    \return size of image in bytes
+*/
+size_t getImageSize (PyARHandle * self);
+
+/**
+    Binds image data for detection by handle to buffer slot. Rows of buffer
+    are reversed, if handle has bottom origin of images.
+    \param self   handle object
+    \param image  python object with image data
+    \param slot   slot holding buffer, it's released, if image data don't match handle
+    \param layout apply pitch and offset of rows to image data
+    \param pitch  distance of rows in bytes, 0 for packed rows
+    \param offset offset of the first row in bytes
+    \return buffer holder in slot, null if image data don't match handle
+*/
+ImageBufferHolder * getImageBuffer (PyARHandle * self, PyObject * image, ImageBufferSlot & slot,
+  bool layout = false, ptrdiff_t pitch = 0, size_t offset = 0);
+
+/**
+    Detects markers in image data. It's called with released interpreter lock
+    and locked handle.
+    \param self  handle object
+    \param image image data
+    \param pitch distance of rows of image data in bytes, 0 for packed rows
+    \return true, if detection was successful
+*/
+bool detectMarkers (PyARHandle * self, ARUint8 * image, ptrdiff_t pitch = 0);
+
+/**
+    Publishes markers of last detection to python objects. It's called with
+    interpreter lock and locked handle.
+    \param self      handle object
+    \param timestamp capture time of image in seconds
+*/
+void publishMarkers (PyARHandle * self, double timestamp);
+
 }
\ No newline at end of file
@@ -0,0 +1,301 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ARHandleGroup.h"
+
+#include "ARHandle.h"
+#include "PyObjectHelper.h"
+#include "PyFastCall.h"
+#include "PyTypeRegistration.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+
+namespace ARTKBlender
+{
+
+/// ARHandleGroup object allocation
+PyObject * PyARHandleGroup_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  // allocate object
+  PyObject * self = type->tp_alloc(type, 0);
+  // initialize object structure
+  PyARHandleGroup * selfObj = getPyType<PyARHandleGroup>(self);
+  selfObj->handles = new PyObjectOwner(PyTuple_New(0));
+  selfObj->handleData = new std::vector<PyARHandle*>;
+  selfObj->handleLocks = new std::vector<std::mutex*>;
+  selfObj->images = new std::vector<ImageBufferSlot>;
+  selfObj->imageData = new std::vector<ARUint8*>;
+  selfObj->results = new std::vector<char>;
+  selfObj->pool = nullptr;
+  selfObj->lock = new std::mutex;
+  // return allocated object
+  return self;
+}
+
+// ARHandleGroup object deallocation
+void PyARHandleGroup_dealloc(PyARHandleGroup * self)
+{
+  // release data, worker threads are stopped first
+  delete self->pool;
+  delete self->results;
+  delete self->imageData;
+  delete self->images;
+  delete self->handleLocks;
+  delete self->handleData;
+  delete self->handles;
+  delete self->lock;
+  // release object
+  deallocPyObject(self);
+}
+
+// ARHandleGroup object initialization
+int PyARHandleGroup_init(PyARHandleGroup * self, PyObject *args, PyObject *kwds)
+{
+  // parse parameter
+  PyObject *handles = NULL;
+  int threads = 0;
+  int pinThreads = 1;
+  static char *kwlist[] = { "handles", "threads", "pinThreads", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|ip", kwlist, &handles, &threads, &pinThreads))
+    return -1;
+
+  // lock group, so detection can't run during change of handles
+  PyMutexLock groupLock(*self->lock);
+
+  // get tuple of handles
+  PyObjectOwner handleTuple(PySequence_Tuple(handles));
+  if (handleTuple.isNull())
+    return -1;
+  size_t handleCount = PyTuple_Size(handleTuple.get());
+  if (handleCount == 0 || threads < 0)
+  {
+    PyErr_SetString(PyExc_ValueError, "At least one handle and non-negative number of threads are required");
+    return -1;
+  }
+
+  // collect handles data, group keeps previous handles, if they're invalid
+  std::vector<PyARHandle*> handleData;
+  std::vector<std::mutex*> handleLocks;
+  for (size_t i = 0; i < handleCount; ++i)
+  {
+    PyObject * handle = PyTuple_GetItem(handleTuple.get(), i);
+    if (!isInstance(handle, ARHandleType) || getPyType<PyARHandle>(handle)->handle == nullptr)
+    {
+      PyErr_SetString(PyExc_TypeError, "Initialized ARHandle objects are required");
+      return -1;
+    }
+    handleData.push_back(getPyType<PyARHandle>(handle));
+    handleLocks.push_back(getPyType<PyARHandle>(handle)->lock);
+  }
+  // sort locks, so they are acquired in same order by all groups
+  std::sort(handleLocks.begin(), handleLocks.end());
+  if (std::adjacent_find(handleLocks.begin(), handleLocks.end()) != handleLocks.end())
+  {
+    PyErr_SetString(PyExc_ValueError, "Handle can't be in group more than once");
+    return -1;
+  }
+  self->handleData->swap(handleData);
+  self->handleLocks->swap(handleLocks);
+  *self->handles = handleTuple;
+
+  // prepare buffers for detection, slots can't be copied, so they're created again
+  delete self->images;
+  self->images = new std::vector<ImageBufferSlot>(handleCount);
+  self->imageData->resize(handleCount);
+  self->results->resize(handleCount);
+
+  // start worker threads
+  delete self->pool;
+  self->pool = new WorkerPool(threads > 0 ? threads : std::min<size_t>(handleCount, std::thread::hardware_concurrency()),
+    pinThreads != 0);
+
+  return 0;
+}
+
+
+// get handles
+PyObject * PyARHandleGroup_getHandles(PyARHandleGroup * self, void * closure)
+{
+  return self->handles->returnValue();
+}
+
+// get number of worker threads
+PyObject * PyARHandleGroup_getThreadCount(PyARHandleGroup * self, void * closure)
+{
+  return PyLong_FromSize_t(self->pool != nullptr ? self->pool->getThreadCount() : 0);
+}
+
+// task detecting markers by one handle of group
+static void detectTask(void * context, size_t index)
+{
+  PyARHandleGroup * self = reinterpret_cast<PyARHandleGroup*>(context);
+  (*self->results)[index] = detectMarkers((*self->handleData)[index], (*self->imageData)[index],
+    (*self->images)[index].get()->getPitch());
+}
+
+// release image buffers of detection
+static void releaseImages(PyARHandleGroup * self)
+{
+  for (auto & imageSlot : *self->images)
+    imageSlot.release();
+}
+
+// detect markers in images of all handles
+PyObject * PyARHandleGroup_detectAll(PyARHandleGroup * self, PyObject * const * args, Py_ssize_t nargs,
+  PyObject * kwnames)
+{
+  // get images
+  static const char * const names[] = { "images", "timestamp" };
+  PyObject * values[] = { nullptr, Py_None };
+  double timestamp;
+  if (!unpackFastArgs("detectAll", args, nargs, kwnames, names, 1, values) || !getTimestamp(values[1], timestamp))
+    return NULL;
+  PyObject * images = values[0];
+  // lock group, buffers of detection and worker pool are used by one call only
+  PyMutexLock groupLock(*self->lock);
+  if (self->pool == nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Group isn't initialized");
+    return NULL;
+  }
+
+  // get sequence of images, their buffers are held until detection ends
+  PyObjectOwner imageSeq(PySequence_Fast(images, "Sequence of images is required"));
+  if (imageSeq.isNull())
+    return NULL;
+  size_t handleCount = self->handleData->size();
+  if (size_t(PySequence_Fast_GET_SIZE(imageSeq.get())) != handleCount)
+  {
+    PyErr_SetString(PyExc_ValueError, "Number of images has to be equal to number of handles");
+    return NULL;
+  }
+  PyObject ** imageItems = PySequence_Fast_ITEMS(imageSeq.get());
+
+  // lock all handles before image buffers are checked, so their sizes can't change until detection ends
+  PyAllowThreads allowThreads;
+  for (auto lock : *self->handleLocks)
+    lock->lock();
+  allowThreads.restore();
+  for (size_t i = 0; i < handleCount; ++i)
+  {
+    ImageBufferHolder * imageBuff = getImageBuffer((*self->handleData)[i], imageItems[i], (*self->images)[i]);
+    if (imageBuff == nullptr)
+    {
+      for (auto lock : *self->handleLocks)
+        lock->unlock();
+      releaseImages(self);
+      Py_RETURN_FALSE;
+    }
+    (*self->imageData)[i] = imageBuff->getData();
+  }
+
+  // release interpreter lock and run detection in worker threads
+  PyAllowThreads detectThreads;
+  self->pool->run(detectTask, self, handleCount);
+
+  // take interpreter lock back to publish markers
+  detectThreads.restore();
+  bool success = true;
+  for (size_t i = 0; i < handleCount; ++i)
+  {
+    if (!(*self->results)[i])
+      success = false;
+    // markers of skipped image keep capture time of the image they were detected in
+    else if (!(*self->handleData)[i]->frameSkipped)
+      publishMarkers((*self->handleData)[i], timestamp);
+  }
+  for (auto lock : *self->handleLocks)
+    lock->unlock();
+
+  releaseImages(self);
+  return PyBool_FromLong(success);
+}
+
+
+// members descriptions
+PyGetSetDef PyARHandleGroup_getseters[] =
+{
+  { "handles", (getter)PyARHandleGroup_getHandles, NULL,
+  "tuple of handles in group", NULL },
+  { "threadCount", (getter)PyARHandleGroup_getThreadCount, NULL,
+  "number of worker threads", NULL },
+  { NULL }  /* Sentinel */
+};
+
+/// methods descriptions
+PyMethodDef PyARHandleGroup_methods[] =
+{
+  { "detectAll", PY_FASTCALL_METHOD(PyARHandleGroup, PyARHandleGroup_detectAll),
+  "Detects markers in sequence of images, one per handle, with optional capture time in parallel, "
+  "return true, if all detections were successful" },
+  { NULL }  /* Sentinel */
+};
+
+
+/// python type structure for ARHandleGroup
+PyTypeObject ARHandleGroupType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARHandleGroup",  /* tp_name */
+  sizeof(PyARHandleGroup),   /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  (destructor)PyARHandleGroup_dealloc,  /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARHandleGroup objects",   /* tp_doc */
+  0,                         /* tp_traverse */
+  0,                         /* tp_clear */
+  0,                         /* tp_richcompare */
+  0,                         /* tp_weaklistoffset */
+  0,                         /* tp_iter */
+  0,                         /* tp_iternext */
+  PyARHandleGroup_methods,   /* tp_methods */
+  0,                         /* tp_members */
+  PyARHandleGroup_getseters, /* tp_getset */
+  0,                         /* tp_base */
+  0,                         /* tp_dict */
+  0,                         /* tp_descr_get */
+  0,                         /* tp_descr_set */
+  0,                         /* tp_dictoffset */
+  (initproc)PyARHandleGroup_init, /* tp_init */
+  0,                         /* tp_alloc */
+  PyARHandleGroup_new,       /* tp_new */
+};
+
+
+// registration object
+static PyTypeRegistration ARHandleGroupReg("ARHandleGroup", ARHandleGroupType);
+
+}
@@ -0,0 +1,64 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <Python.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "PyObjectHelper.h"
+#include "BlenderUtils.h"
+#include "WorkerPool.h"
+
+namespace ARTKBlender
+{
+
+struct PyARHandle;
+
+/// python data structure for group of ARHandles processed in parallel
+struct PyARHandleGroup
+{
+  PyObject_HEAD
+  /// tuple of handles in group
+  PyObjectOwner * handles;
+  /// handles data structures
+  std::vector<PyARHandle*> * handleData;
+  /// locks of handles sorted by address, so they're always acquired in same order
+  std::vector<std::mutex*> * handleLocks;
+  /// slots of image buffers, one per handle, they're bound to images of every detection
+  std::vector<ImageBufferSlot> * images;
+  /// image data of current detection
+  std::vector<ARUint8*> * imageData;
+  /// results of current detection
+  std::vector<char> * results;
+  /// pool of worker threads
+  WorkerPool * pool;
+  /// lock of group, it serializes detections and initialization, so buffers and pool aren't shared
+  std::mutex * lock;
+};
+
+// declaration of python module type
+extern PyTypeObject ARHandleGroupType;
+
+}
@@ -0,0 +1,201 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ARMarkerArray.h"
+
+#include "PyObjectHelper.h"
+#include "PyTypeRegistration.h"
+
+#include <cstddef>
+
+namespace ARTKBlender
+{
+
+/// format of marker record according to PEP 3118
+static char markerRecordFormat[] = "T{i:id:i:area:i:dir:4x:d:cf:(2)d:pos:(4,2)d:vertex:(4,3)d:line:}";
+
+/// stride of exported buffer
+static Py_ssize_t markerRecordStride = sizeof(ARMarkerRecord);
+
+static_assert(offsetof(ARMarkerRecord, cf) == 16 && sizeof(ARMarkerRecord) == 200,
+  "Marker record doesn't match its buffer format");
+
+
+/// ARMarkerArray object allocation
+PyObject * PyARMarkerArray_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  // allocate object
+  PyObject * self = type->tp_alloc(type, 0);
+  // initialize object structure
+  PyARMarkerArray * selfObj = getPyType<PyARMarkerArray>(self);
+  selfObj->records = new std::vector<ARMarkerRecord>;
+  selfObj->shape = 0;
+  selfObj->exports = 0;
+  // return allocated object
+  return self;
+}
+
+// ARMarkerArray object deallocation
+void PyARMarkerArray_dealloc(PyARMarkerArray * self)
+{
+  // release data
+  delete self->records;
+  // release object
+  deallocPyObject(self);
+}
+
+// get number of markers
+Py_ssize_t PyARMarkerArray_length(PyARMarkerArray * self)
+{
+  return self->shape;
+}
+
+// export read only buffer with marker records
+int PyARMarkerArray_getBuffer(PyARMarkerArray * self, Py_buffer * view, int flags)
+{
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+  {
+    PyErr_SetString(PyExc_BufferError, "Marker array is read only");
+    view->obj = NULL;
+    return -1;
+  }
+  view->obj = getPyObject(self);
+  Py_INCREF(view->obj);
+  view->buf = self->records->data();
+  view->len = self->shape * sizeof(ARMarkerRecord);
+  view->readonly = 1;
+  view->itemsize = sizeof(ARMarkerRecord);
+  view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? markerRecordFormat : NULL;
+  view->ndim = 1;
+  view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &self->shape : NULL;
+  view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &markerRecordStride : NULL;
+  view->suboffsets = NULL;
+  view->internal = NULL;
+  ++self->exports;
+  return 0;
+}
+
+// release exported buffer
+void PyARMarkerArray_releaseBuffer(PyARMarkerArray * self, Py_buffer * view)
+{
+  --self->exports;
+}
+
+
+// fill marker array
+bool updateMarkerArray (PyObjectOwner & array, const ARMarkerInfo * markers, int count)
+{
+  // create new array, if current one is referenced elsewhere
+  if (array.isNull() || Py_REFCNT(array.get()) > 1 || getPyType<PyARMarkerArray>(array.get())->exports > 0)
+  {
+    array = PyObjectOwner(PyObject_CallObject(getPyObject(&ARMarkerArrayType), NULL));
+    if (array.isNull())
+      return false;
+  }
+  // copy marker values to records
+  PyARMarkerArray * arrayObj = getPyType<PyARMarkerArray>(array.get());
+  arrayObj->records->resize(count);
+  arrayObj->shape = count;
+  for (int i = 0; i < count; ++i)
+  {
+    ARMarkerRecord & record = (*arrayObj->records)[i];
+    const ARMarkerInfo & marker = markers[i];
+    record.id = marker.id;
+    record.area = marker.area;
+    record.dir = marker.dir;
+    record.reserved = 0;
+    record.cf = marker.cf;
+    for (int j = 0; j < 2; ++j)
+      record.pos[j] = marker.pos[j];
+    for (int j = 0; j < 4; ++j)
+    {
+      for (int k = 0; k < 2; ++k)
+        record.vertex[j][k] = marker.vertex[j][k];
+      for (int k = 0; k < 3; ++k)
+        record.line[j][k] = marker.line[j][k];
+    }
+  }
+  return true;
+}
+
+
+/// sequence methods
+PySequenceMethods PyARMarkerArray_sequence =
+{
+  (lenfunc)PyARMarkerArray_length, /* sq_length */
+};
+
+/// buffer methods
+PyBufferProcs PyARMarkerArray_buffer =
+{
+  (getbufferproc)PyARMarkerArray_getBuffer,  /* bf_getbuffer */
+  (releasebufferproc)PyARMarkerArray_releaseBuffer,  /* bf_releasebuffer */
+};
+
+
+/// python type structure for ARMarkerArray
+PyTypeObject ARMarkerArrayType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARMarkerArray", /* tp_name */
+  sizeof(PyARMarkerArray),   /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  (destructor)PyARMarkerArray_dealloc,  /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  &PyARMarkerArray_sequence, /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  &PyARMarkerArray_buffer,   /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARMarkerArray objects, buffer of marker records", /* tp_doc */
+  0,                         /* tp_traverse */
+  0,                         /* tp_clear */
+  0,                         /* tp_richcompare */
+  0,                         /* tp_weaklistoffset */
+  0,                         /* tp_iter */
+  0,                         /* tp_iternext */
+  0,                         /* tp_methods */
+  0,                         /* tp_members */
+  0,                         /* tp_getset */
+  0,                         /* tp_base */
+  0,                         /* tp_dict */
+  0,                         /* tp_descr_get */
+  0,                         /* tp_descr_set */
+  0,                         /* tp_dictoffset */
+  0,                         /* tp_init */
+  0,                         /* tp_alloc */
+  PyARMarkerArray_new,       /* tp_new */
+};
+
+
+// registration object
+static PyTypeRegistration ARMarkerArrayReg("ARMarkerArray", ARMarkerArrayType);
+
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <Python.h>
+#include <vector>
+
+#include "PyObjectHelper.h"
+
+namespace ARTKBlender
+{
+
+/// record of one marker in ARMarkerArray buffer
+struct ARMarkerRecord
+{
+  /// pattern ID
+  int id;
+  /// area in pixels
+  int area;
+  /// direction of pattern
+  int dir;
+  /// padding to align following values
+  int reserved;
+  /// detection confidence
+  double cf;
+  /// center of marker
+  double pos[2];
+  /// vertices of marker
+  double vertex[4][2];
+  /// line coefficients of marker edges
+  double line[4][3];
+};
+
+/// python data structure for ARMarkerArray
+struct PyARMarkerArray
+{
+  PyObject_HEAD
+  /// marker records
+  std::vector<ARMarkerRecord> * records;
+  /// shape of exported buffer
+  Py_ssize_t shape;
+  /// number of exported buffers
+  int exports;
+};
+
+// declaration of python module type
+extern PyTypeObject ARMarkerArrayType;
+
+/**
+    Fills marker array with copies of markers, if array isn't referenced elsewhere,
+    otherwise new array is created.
+    \param array   holder of marker array, it may hold null
+    \param markers detected markers
+    \param count   number of markers
+    \return false, if array creation failed
+*/
+bool updateMarkerArray (PyObjectOwner & array, const ARMarkerInfo * markers, int count);
+
+}
\ No newline at end of file
@@ -24,6 +24,8 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #include "PyObjectHelper.h"
 #include "PyTypeRegistration.h"
 
+#include <cstring>
+
 namespace ARTKBlender
 {
 
@@ -34,7 +36,8 @@ PyObject * PyARMarkerInfo_new(PyTypeObject *type, PyObject *args, PyObject *kwds
   PyObject * self = type->tp_alloc(type, 0);
   // initialize object structure
   PyARMarkerInfo * selfObj = getPyType<PyARMarkerInfo>(self);
-  selfObj->marker = nullptr;
+  std::memset(&selfObj->marker, 0, sizeof(ARMarkerInfo));
+  selfObj->timestamp = 0.0;
   // return allocated object
   return self;
 }
@@ -49,13 +52,19 @@ void PyARMarkerInfo_dealloc(PyARMarkerInfo * self)
 // get ID of detected pattern
 PyObject * PyARMarkerInfo_getID(PyARMarkerInfo * self, void * closure)
 {
-  return PyLong_FromLong(self->marker->id);
+  return PyLong_FromLong(self->marker.id);
 }
 
 // get ID of detected pattern
 PyObject * PyARMarkerInfo_getCF(PyARMarkerInfo * self, void * closure)
 {
-  return PyFloat_FromDouble(self->marker->cf);
+  return PyFloat_FromDouble(self->marker.cf);
+}
+
+// get capture time of image with marker
+PyObject * PyARMarkerInfo_getTimestamp(PyARMarkerInfo * self, void * closure)
+{
+  return PyFloat_FromDouble(self->timestamp);
 }
 
 
@@ -66,6 +75,8 @@ PyGetSetDef PyARMarkerInfo_getseters[] =
   "pattern ID", NULL },
   { "cf", (getter)PyARMarkerInfo_getCF, NULL,
   "detection confidence", NULL },
+  { "timestamp", (getter)PyARMarkerInfo_getTimestamp, NULL,
+  "capture time of image in seconds", NULL },
   { NULL }  /* Sentinel */
 };
 
@@ -125,4 +136,66 @@ PyTypeObject ARMarkerInfoType =
 // registration object
 static PyTypeRegistration ARMarkerInfoReg("ARMarkerInfo", ARMarkerInfoType);
 
+
+// implementation of marker objects pool
+
+// constructor
+ARMarkerInfoPool::ARMarkerInfoPool (void)
+{}
+
+// get tuple of markers
+PyObject * ARMarkerInfoPool::getMarkers (const ARMarkerInfo * markers, int count, double timestamp)
+{
+  // get tuple of required size, it's reused if nobody else refers to it
+  if (tuples.size() <= size_t(count))
+    tuples.resize(count + 1);
+  PyObjectOwner & tuple = tuples[count];
+  if (tuple.isNull() || (count > 0 && Py_REFCNT(tuple.get()) > 1))
+  {
+    tuple = PyObjectOwner(PyTuple_New(count));
+    if (tuple.isNull())
+      return nullptr;
+  }
+
+  // fill tuple with marker objects
+  if (objects.size() < size_t(count))
+    objects.resize(count);
+  for (int i = 0; i < count; ++i)
+  {
+    // replace object referenced from python code
+    if (!isPoolOnly(i))
+    {
+      PyARMarkerInfo * newMarker = PyObject_New(PyARMarkerInfo, &ARMarkerInfoType);
+      if (newMarker == nullptr)
+        return nullptr;
+      objects[i] = PyObjectOwner(getPyObject(newMarker));
+    }
+    PyARMarkerInfo * marker = getPyType<PyARMarkerInfo>(objects[i].get());
+    marker->marker = markers[i];
+    marker->timestamp = timestamp;
+    // place object to tuple, previous item is released
+    if (PyTuple_GET_ITEM(tuple.get(), i) != objects[i].get())
+      PyTuple_SetItem(tuple.get(), i, objects[i].returnValue());
+  }
+  return tuple.returnValue();
+}
+
+// check if object is referenced only by pool
+bool ARMarkerInfoPool::isPoolOnly (size_t index)
+{
+  PyObject * object = objects[index].get();
+  if (object == nullptr)
+    return false;
+  // count references from objects list and from tuples, which aren't referenced elsewhere
+  Py_ssize_t poolRefs = 1;
+  for (auto & tuple : tuples)
+    if (!tuple.isNull() && size_t(PyTuple_GET_SIZE(tuple.get())) > index && PyTuple_GET_ITEM(tuple.get(), index) == object)
+    {
+      if (Py_REFCNT(tuple.get()) > 1)
+        return false;
+      ++poolRefs;
+    }
+  return Py_REFCNT(object) == poolRefs;
+}
+
 }
\ No newline at end of file
@@ -23,6 +23,9 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <AR/ar.h>
 #include <Python.h>
+#include <vector>
+
+#include "PyObjectHelper.h"
 
 namespace ARTKBlender
 {
@@ -31,11 +34,52 @@ namespace ARTKBlender
 struct PyARMarkerInfo
 {
   PyObject_HEAD
-  /// AR3DHandle structure
-  ARMarkerInfo * marker;
+  /// copy of detected marker, it doesn't change while object is referenced
+  ARMarkerInfo marker;
+  /// capture time of image, in which marker was detected, in seconds
+  double timestamp;
 };
 
 // declaration of python module type
 extern PyTypeObject ARMarkerInfoType;
 
+
+/**
+    Pool of ARMarkerInfo python objects and tuples of them.
+
+    Objects and tuples are reused after every detection, if they are referenced
+    only by the pool. Objects still referenced from python code are replaced by
+    new ones, so they keep data of their detection.
+*/
+class ARMarkerInfoPool
+{
+public:
+  /**
+      Constructor creates empty pool.
+  */
+  ARMarkerInfoPool (void);
+
+  /**
+      Provides tuple of marker objects with copies of markers.
+      \param markers   detected markers
+      \param count     number of markers
+      \param timestamp capture time of image with markers
+      \return new reference to tuple, null if allocation failed
+  */
+  PyObject * getMarkers (const ARMarkerInfo * markers, int count, double timestamp);
+
+protected:
+  /// marker objects, object at index is placed at the same index in tuples
+  std::vector<PyObjectOwner> objects;
+  /// tuples of marker objects indexed by their size
+  std::vector<PyObjectOwner> tuples;
+
+  /**
+      Checks if object at index is referenced only by pool.
+      \param index index of object
+      \return true, if object can be changed
+  */
+  bool isPoolOnly (size_t index);
+};
+
 }
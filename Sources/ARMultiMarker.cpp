@@ -0,0 +1,211 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ARMultiMarker.h"
+
+#include "ARHandle.h"
+#include "AR3DHandle.h"
+#include "ARPattHandle.h"
+#include "MatrixUtils.h"
+#include "PyObjectHelper.h"
+#include "PyTypeRegistration.h"
+
+namespace ARTKBlender
+{
+
+/// ARMultiMarker object allocation
+PyObject * PyARMultiMarker_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  // allocate object
+  PyObject * self = type->tp_alloc(type, 0);
+  // initialize object structure
+  PyARMultiMarker * selfObj = getPyType<PyARMultiMarker>(self);
+  selfObj->config = nullptr;
+  selfObj->pattHandle = new PyObjectOwner;
+  selfObj->error = -1.0;
+  selfObj->markersUsed = 0;
+  // return allocated object
+  return self;
+}
+
+// ARMultiMarker object deallocation
+void PyARMultiMarker_dealloc(PyARMultiMarker * self)
+{
+  // release data
+  if (self->config != nullptr)
+    arMultiFreeConfig(self->config);
+  delete self->pattHandle;
+  // release object
+  deallocPyObject(self);
+}
+
+// ARMultiMarker object initialization
+int PyARMultiMarker_init(PyARMultiMarker * self, PyObject *args, PyObject *kwds)
+{
+  // parse parameters
+  const char * fileName = nullptr;
+  PyObject * pattHandle = NULL;
+  static char *kwlist[] = { "fileName", "pattHandle", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "sO!", kwlist, &fileName, &ARPattHandleType, &pattHandle))
+    return -1;
+
+  // load configuration, its patterns are loaded to pattern handle
+  ARMultiMarkerInfoT * config = arMultiReadConfigFile(fileName, getPyType<PyARPattHandle>(pattHandle)->handle);
+  if (config == nullptr)
+  {
+    PyErr_Format(PyExc_IOError, "Loading of multi-marker configuration %s failed", fileName);
+    return -1;
+  }
+  if (self->config != nullptr)
+    arMultiFreeConfig(self->config);
+  self->config = config;
+  *self->pattHandle = PyObjectOwner(pattHandle, true);
+  return 0;
+}
+
+// get transformation matrix of multi-marker from markers detected by handle
+PyObject * PyARMultiMarker_getTransMat(PyARMultiMarker * self, PyObject * args, PyObject * kwds)
+{
+  // get arguments
+  PyObject * handle3D;
+  PyObject * handle;
+  PyObject * out = Py_None;
+  int quaternion = 0;
+  static char *kwlist[] = { "handle3D", "handle", "out", "quaternion", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!O!|Op", kwlist, &AR3DHandleType, &handle3D, &ARHandleType, &handle,
+      &out, &quaternion))
+    return NULL;
+  if (self->config == nullptr)
+  {
+    PyErr_SetString(PyExc_RuntimeError, "Multi-marker configuration isn't loaded");
+    return NULL;
+  }
+
+  // solve pose from all visible markers of configuration
+  PyARHandle * handleObj = getPyType<PyARHandle>(handle);
+  PyAR3DHandle * handle3DObj = getPyType<PyAR3DHandle>(handle3D);
+  {
+    PyMutexLock lock(*handle3DObj->lock);
+    self->error = arGetTransMatMultiSquareRobust(handle3DObj->handle, handleObj->markerInfo, handleObj->markerNum,
+      self->config);
+  }
+  self->markersUsed = 0;
+  for (int i = 0; i < self->config->marker_num; ++i)
+    if (self->config->marker[i].visible >= 0)
+      ++self->markersUsed;
+  if (self->error < 0.0 || self->markersUsed == 0)
+    Py_RETURN_NONE;
+
+  // return pose
+  return returnPose(self->config->trans, out, quaternion != 0);
+}
+
+
+// get fit error of the last solve
+PyObject * PyARMultiMarker_getError(PyARMultiMarker * self, void * closure)
+{
+  return PyFloat_FromDouble(self->error);
+}
+
+// get number of markers used by the last solve
+PyObject * PyARMultiMarker_getMarkersUsed(PyARMultiMarker * self, void * closure)
+{
+  return PyLong_FromLong(self->markersUsed);
+}
+
+// get number of markers in configuration
+PyObject * PyARMultiMarker_getMarkerCount(PyARMultiMarker * self, void * closure)
+{
+  return PyLong_FromLong(self->config != nullptr ? self->config->marker_num : 0);
+}
+
+
+// members descriptions
+PyGetSetDef PyARMultiMarker_getseters[] =
+{
+  { "error", (getter)PyARMultiMarker_getError, NULL,
+  "reprojection error of the last solve, negative if it failed", NULL },
+  { "markersUsed", (getter)PyARMultiMarker_getMarkersUsed, NULL,
+  "number of markers used by the last solve", NULL },
+  { "markerCount", (getter)PyARMultiMarker_getMarkerCount, NULL,
+  "number of markers in configuration", NULL },
+  { NULL }  /* Sentinel */
+};
+
+/// methods descriptions
+PyMethodDef PyARMultiMarker_methods[] =
+{
+  { "getTransMat", (PyCFunction)PyARMultiMarker_getTransMat, METH_VARARGS | METH_KEYWORDS,
+  "Get transformation matrix of multi-marker using AR3DHandle and markers detected by ARHandle, "
+  "written to out buffer or as quaternion with translation, if requested, "
+  "return None if no marker of configuration is visible." },
+  { NULL }  /* Sentinel */
+};
+
+
+/// python type structure for ARMultiMarker
+PyTypeObject ARMultiMarkerType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARMultiMarker", /* tp_name */
+  sizeof(PyARMultiMarker),   /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  (destructor)PyARMultiMarker_dealloc,  /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARMultiMarker objects",   /* tp_doc */
+  0,                         /* tp_traverse */
+  0,                         /* tp_clear */
+  0,                         /* tp_richcompare */
+  0,                         /* tp_weaklistoffset */
+  0,                         /* tp_iter */
+  0,                         /* tp_iternext */
+  PyARMultiMarker_methods,   /* tp_methods */
+  0,                         /* tp_members */
+  PyARMultiMarker_getseters, /* tp_getset */
+  0,                         /* tp_base */
+  0,                         /* tp_dict */
+  0,                         /* tp_descr_get */
+  0,                         /* tp_descr_set */
+  0,                         /* tp_dictoffset */
+  (initproc)PyARMultiMarker_init, /* tp_init */
+  0,                         /* tp_alloc */
+  PyARMultiMarker_new,       /* tp_new */
+};
+
+
+// registration object
+static PyTypeRegistration ARMultiMarkerReg("ARMultiMarker", ARMultiMarkerType);
+
+}
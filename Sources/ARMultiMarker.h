@@ -0,0 +1,50 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <AR/arMulti.h>
+#include <Python.h>
+
+#include "PyObjectHelper.h"
+
+namespace ARTKBlender
+{
+
+/// python data structure for ARMultiMarker
+struct PyARMultiMarker
+{
+  PyObject_HEAD
+  /// multi-marker configuration
+  ARMultiMarkerInfoT * config;
+  /// pattern handle with patterns of configuration
+  PyObjectOwner * pattHandle;
+  /// fit error of the last solve, negative if it failed
+  double error;
+  /// number of markers used by the last solve
+  int markersUsed;
+};
+
+// declaration of python module type
+extern PyTypeObject ARMultiMarkerType;
+
+}
@@ -22,7 +22,9 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #include "ARParam.h"
 
 #include "PyObjectHelper.h"
+#include "PyFastCall.h"
 #include "PyTypeRegistration.h"
+#include "ParamLTCache.h"
 
 namespace ARTKBlender
 {
@@ -105,12 +107,14 @@ PyObject * PyARParam_getDistFactor(PyARParam * self, void * closure)
 }
 
 // load data file to ARParam object
-PyObject * PyARParam_load (PyARParam * self, PyObject * args)
+PyObject * PyARParam_load (PyARParam * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames)
 {
   // get file name
+  static const char * const names[] = { "fileName" };
+  PyObject * values[] = { nullptr };
   const char * fileName = nullptr;
-  if (!PyArg_ParseTuple(args, "s", &fileName))
-    Py_RETURN_FALSE;
+  if (!unpackFastArgs("load", args, nargs, kwnames, names, 1, values) || !getArgString("load", values[0], fileName))
+    return NULL;
 
   // load data from file and return result
   if (arParamLoad(fileName, 1, self->param) != 0)
@@ -119,6 +123,31 @@ PyObject * PyARParam_load (PyARParam * self, PyObject * args)
   Py_RETURN_TRUE;
 }
 
+// save lookup table of parameters to snapshot file
+PyObject * PyARParam_saveLookupTable (PyARParam * self, PyObject * const * args, Py_ssize_t nargs,
+  PyObject * kwnames)
+{
+  // get file name
+  static const char * const names[] = { "fileName" };
+  PyObject * values[] = { nullptr };
+  const char * fileName = nullptr;
+  if (!unpackFastArgs("saveLookupTable", args, nargs, kwnames, names, 1, values) ||
+      !getArgString("saveLookupTable", values[0], fileName))
+    return NULL;
+
+  // table may be computed, so interpreter lock is released
+  ARParam param = *self->param;
+  PyAllowThreads allowThreads;
+  bool result = ParamLTCache::getInstance().saveSnapshot(param, AR_PARAM_LT_DEFAULT_OFFSET, fileName);
+  allowThreads.restore();
+  if (!result)
+  {
+    PyErr_Format(PyExc_OSError, "Lookup table snapshot '%s' can't be saved", fileName);
+    return NULL;
+  }
+  Py_RETURN_TRUE;
+}
+
 
 // members descriptions
 PyGetSetDef PyARParam_getseters[] =
@@ -135,8 +164,10 @@ PyGetSetDef PyARParam_getseters[] =
 /// methods descriptions
 PyMethodDef PyARParam_methods[] =
 {
-  { "load", (PyCFunction)PyARParam_load, METH_VARARGS,
+  { "load", PY_FASTCALL_METHOD(PyARParam, PyARParam_load),
     "Loads data from file, return true, if successful" },
+  { "saveLookupTable", PY_FASTCALL_METHOD(PyARParam, PyARParam_saveLookupTable),
+  "Saves lookup table for current parameters to snapshot file, which handles can map, return true, raise OSError on failure" },
   { NULL }  /* Sentinel */
 };
 
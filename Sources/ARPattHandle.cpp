@@ -22,6 +22,7 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #include "ARPattHandle.h"
 
 #include "PyObjectHelper.h"
+#include "PyFastCall.h"
 #include "PyTypeRegistration.h"
 
 namespace ARTKBlender
@@ -49,12 +50,14 @@ void PyARPattHandle_dealloc(PyARPattHandle * self)
 }
 
 // load pattern data file to ARPattHandle object
-PyObject * PyARPattHandle_load(PyARPattHandle * self, PyObject * args)
+PyObject * PyARPattHandle_load(PyARPattHandle * self, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames)
 {
   // get file name
+  static const char * const names[] = { "fileName" };
+  PyObject * values[] = { nullptr };
   const char * fileName = nullptr;
-  if (!PyArg_ParseTuple(args, "s", &fileName))
-    return Py_False;
+  if (!unpackFastArgs("load", args, nargs, kwnames, names, 1, values) || !getArgString("load", values[0], fileName))
+    return NULL;
 
   // load data from file and return pattern ID
   return PyLong_FromLong(arPattLoad(self->handle, fileName));
@@ -72,7 +75,7 @@ PyGetSetDef PyARPattHandle_getseters[] =
 /// methods descriptions
 PyMethodDef PyARPattHandle_methods[] =
 {
-  { "load", (PyCFunction)PyARPattHandle_load, METH_VARARGS,
+  { "load", PY_FASTCALL_METHOD(PyARPattHandle, PyARPattHandle_load),
   "Loads pattern data from file, return index of pattern or -1 if failed" },
   { NULL }  /* Sentinel */
 };
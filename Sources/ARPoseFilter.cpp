@@ -0,0 +1,270 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ARPoseFilter.h"
+
+#include "PoseFilter.h"
+#include "TimeUtils.h"
+#include "MatrixUtils.h"
+#include "PyObjectHelper.h"
+#include "PyTypeRegistration.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/// ARPoseFilter object allocation
+PyObject * PyARPoseFilter_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  // allocate object
+  PyObject * self = type->tp_alloc(type, 0);
+  // initialize object structure
+  PyARPoseFilter * selfObj = getPyType<PyARPoseFilter>(self);
+  selfObj->filter = new PoseFilter;
+  // return allocated object
+  return self;
+}
+
+// ARPoseFilter object deallocation
+void PyARPoseFilter_dealloc(PyARPoseFilter * self)
+{
+  // release data
+  delete self->filter;
+  // release object
+  deallocPyObject(self);
+}
+
+// ARPoseFilter object initialization
+int PyARPoseFilter_init(PyARPoseFilter * self, PyObject *args, PyObject *kwds)
+{
+  // parse parameters
+  PoseFilter & filter = *self->filter;
+  static char *kwlist[] = { "minCutoff", "beta", "derivativeCutoff", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ddd", kwlist, &filter.minCutoff, &filter.beta,
+      &filter.derivativeCutoff))
+    return -1;
+
+  // check parameters
+  if (filter.minCutoff <= 0.0 || filter.beta < 0.0 || filter.derivativeCutoff <= 0.0)
+  {
+    PyErr_SetString(PyExc_ValueError, "Cutoff frequencies have to be positive and beta non-negative");
+    return -1;
+  }
+  return 0;
+}
+
+// filter poses of markers
+PyObject * PyARPoseFilter_filter(PyARPoseFilter * self, PyObject * args, PyObject * kwds)
+{
+  // get arguments
+  PyObject * idsArg;
+  PyObject * poses;
+  PyObject * timeArg = Py_None;
+  PyObject * out = Py_None;
+  static char *kwlist[] = { "ids", "poses", "timestamp", "out", NULL };
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|OO", kwlist, &idsArg, &poses, &timeArg, &out))
+    return NULL;
+  double time;
+  if (!getTimestamp(timeArg, time))
+    return NULL;
+
+  // get pattern IDs
+  PyObjectOwner idsSeq(PySequence_Fast(idsArg, "IDs have to be sequence of integers"));
+  if (idsSeq.isNull())
+    return NULL;
+  Py_ssize_t count = PySequence_Fast_GET_SIZE(idsSeq.get());
+  std::vector<int> ids(count);
+  for (Py_ssize_t i = 0; i < count; ++i)
+  {
+    ids[i] = int(PyLong_AsLong(PySequence_Fast_GET_ITEM(idsSeq.get(), i)));
+    if (PyErr_Occurred())
+      return NULL;
+  }
+
+  // copy input poses, output may be the same buffer
+  std::vector<double> mats(count * 16);
+  Py_buffer buffer;
+  if (!getMatrixBuffer(poses, &buffer, count, false))
+    return NULL;
+  std::copy(static_cast<double*>(buffer.buf), static_cast<double*>(buffer.buf) + count * 16, mats.begin());
+  PyBuffer_Release(&buffer);
+
+  // filter poses
+  double (*matArray)[4][4] = reinterpret_cast<double(*)[4][4]>(mats.data());
+  for (Py_ssize_t i = 0; i < count; ++i)
+    self->filter->filter(ids[i], time, matArray[i]);
+
+  // write filtered poses to output buffer
+  PyObjectOwner result(out == Py_None ? createMatrixBuffer(count) : out, out != Py_None);
+  if (result.isNull() || !getMatrixBuffer(result.get(), &buffer, count, true))
+    return NULL;
+  std::copy(mats.begin(), mats.end(), static_cast<double*>(buffer.buf));
+  PyBuffer_Release(&buffer);
+  return result.returnValue();
+}
+
+// forget states of markers
+PyObject * PyARPoseFilter_reset(PyARPoseFilter * self)
+{
+  self->filter->reset();
+  Py_RETURN_NONE;
+}
+
+
+// set parameter value, which has to be positive or non-negative
+static int setParameter(PyObject * value, double & parameter, bool allowZero)
+{
+  double number = value != NULL ? PyFloat_AsDouble(value) : -1.0;
+  if (number < 0.0 || (number == 0.0 && !allowZero))
+  {
+    PyErr_Clear();
+    PyErr_SetString(PyExc_ValueError, allowZero ? "Value has to be non-negative number" : "Value has to be positive number");
+    return -1;
+  }
+  parameter = number;
+  return 0;
+}
+
+// get minimal cutoff frequency
+PyObject * PyARPoseFilter_getMinCutoff(PyARPoseFilter * self, void * closure)
+{
+  return PyFloat_FromDouble(self->filter->minCutoff);
+}
+
+// set minimal cutoff frequency
+int PyARPoseFilter_setMinCutoff(PyARPoseFilter * self, PyObject *value, void *closure)
+{
+  return setParameter(value, self->filter->minCutoff, false);
+}
+
+// get speed coefficient
+PyObject * PyARPoseFilter_getBeta(PyARPoseFilter * self, void * closure)
+{
+  return PyFloat_FromDouble(self->filter->beta);
+}
+
+// set speed coefficient
+int PyARPoseFilter_setBeta(PyARPoseFilter * self, PyObject *value, void *closure)
+{
+  return setParameter(value, self->filter->beta, true);
+}
+
+// get cutoff frequency of speed
+PyObject * PyARPoseFilter_getDerivativeCutoff(PyARPoseFilter * self, void * closure)
+{
+  return PyFloat_FromDouble(self->filter->derivativeCutoff);
+}
+
+// set cutoff frequency of speed
+int PyARPoseFilter_setDerivativeCutoff(PyARPoseFilter * self, PyObject *value, void *closure)
+{
+  return setParameter(value, self->filter->derivativeCutoff, false);
+}
+
+// get expiry time of marker states
+PyObject * PyARPoseFilter_getExpiry(PyARPoseFilter * self, void * closure)
+{
+  return PyFloat_FromDouble(self->filter->expiry);
+}
+
+// set expiry time of marker states
+int PyARPoseFilter_setExpiry(PyARPoseFilter * self, PyObject *value, void *closure)
+{
+  return setParameter(value, self->filter->expiry, true);
+}
+
+
+// members descriptions
+PyGetSetDef PyARPoseFilter_getseters[] =
+{
+  { "minCutoff", (getter)PyARPoseFilter_getMinCutoff, (setter)PyARPoseFilter_setMinCutoff,
+  "minimal cutoff frequency in Hz", NULL },
+  { "beta", (getter)PyARPoseFilter_getBeta, (setter)PyARPoseFilter_setBeta,
+  "increase of cutoff frequency per unit of speed", NULL },
+  { "derivativeCutoff", (getter)PyARPoseFilter_getDerivativeCutoff, (setter)PyARPoseFilter_setDerivativeCutoff,
+  "cutoff frequency of speed in Hz", NULL },
+  { "expiry", (getter)PyARPoseFilter_getExpiry, (setter)PyARPoseFilter_setExpiry,
+  "maximal time in seconds between poses of marker, filter is restarted after longer time", NULL },
+  { NULL }  /* Sentinel */
+};
+
+/// methods descriptions
+PyMethodDef PyARPoseFilter_methods[] =
+{
+  { "filter", (PyCFunction)PyARPoseFilter_filter, METH_VARARGS | METH_KEYWORDS,
+  "Filter poses of markers with pattern IDs from float64 buffer with 16 values per marker, "
+  "return (N,4,4) float64 buffer, which may be supplied as out." },
+  { "reset", (PyCFunction)PyARPoseFilter_reset, METH_NOARGS,
+  "Forget filtered poses of all markers." },
+  { NULL }  /* Sentinel */
+};
+
+
+/// python type structure for ARPoseFilter
+PyTypeObject ARPoseFilterType =
+{
+  PyVarObject_HEAD_INIT(NULL, 0)
+  "ARTKBlender.ARPoseFilter", /* tp_name */
+  sizeof(PyARPoseFilter),    /* tp_basicsize */
+  0,                         /* tp_itemsize */
+  (destructor)PyARPoseFilter_dealloc,  /* tp_dealloc */
+  0,                         /* tp_print */
+  0,                         /* tp_getattr */
+  0,                         /* tp_setattr */
+  0,                         /* tp_reserved */
+  0,                         /* tp_repr */
+  0,                         /* tp_as_number */
+  0,                         /* tp_as_sequence */
+  0,                         /* tp_as_mapping */
+  0,                         /* tp_hash  */
+  0,                         /* tp_call */
+  0,                         /* tp_str */
+  0,                         /* tp_getattro */
+  0,                         /* tp_setattro */
+  0,                         /* tp_as_buffer */
+  Py_TPFLAGS_DEFAULT,        /* tp_flags */
+  "ARPoseFilter objects",    /* tp_doc */
+  0,                         /* tp_traverse */
+  0,                         /* tp_clear */
+  0,                         /* tp_richcompare */
+  0,                         /* tp_weaklistoffset */
+  0,                         /* tp_iter */
+  0,                         /* tp_iternext */
+  PyARPoseFilter_methods,    /* tp_methods */
+  0,                         /* tp_members */
+  PyARPoseFilter_getseters,  /* tp_getset */
+  0,                         /* tp_base */
+  0,                         /* tp_dict */
+  0,                         /* tp_descr_get */
+  0,                         /* tp_descr_set */
+  0,                         /* tp_dictoffset */
+  (initproc)PyARPoseFilter_init, /* tp_init */
+  0,                         /* tp_alloc */
+  PyARPoseFilter_new,        /* tp_new */
+};
+
+
+// registration object
+static PyTypeRegistration ARPoseFilterReg("ARPoseFilter", ARPoseFilterType);
+
+}
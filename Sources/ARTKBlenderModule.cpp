@@ -21,14 +21,38 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <Python.h>
 
+#include "PyObjectHelper.h"
 #include "PyTypeRegistration.h"
+#include "TimeUtils.h"
+#include "ParamLTCache.h"
 
 namespace ARTKBlender
 {
 
+// get time of clock used for timestamps
+static PyObject * moduleClock (PyObject * self)
+{
+  return PyFloat_FromDouble(getClockTime());
+}
+
+// get statistics of shared lookup tables
+static PyObject * moduleParamLTCacheStats (PyObject * self)
+{
+  PyAllowThreads allowThreads;
+  ParamLTCache::Stats stats = ParamLTCache::getInstance().getStats();
+  allowThreads.restore();
+  return Py_BuildValue("{sKsKsnsnsnsn}", "hits", stats.hits, "misses", stats.misses,
+    "tables", Py_ssize_t(stats.tables), "unused", Py_ssize_t(stats.unused), "mapped", Py_ssize_t(stats.mapped),
+    "memory", Py_ssize_t(stats.memory));
+}
+
 // module methods
 static PyMethodDef moduleMethods[] =
 {
+  { "clock", (PyCFunction)moduleClock, METH_NOARGS,
+  "Returns time in seconds of monotonic clock used for capture timestamps" },
+  { "paramLTCacheStats", (PyCFunction)moduleParamLTCacheStats, METH_NOARGS,
+  "Returns dictionary with hits, misses, number of tables, unused and mapped tables and memory of shared lookup tables" },
   { NULL }  /* Sentinel */
 };
 
@@ -46,6 +70,11 @@ static PyModuleDef ARTKBlenderModule =
 // initialization of module
 PyMODINIT_FUNC PyInit_ARTKBlender (void)
 {
+#if PY_VERSION_HEX < 0x03070000
+  // initialize interpreter lock, detection releases it while processing images
+  PyEval_InitThreads();
+#endif
+
   // prepare classes
   if (!PyTypeRegistration::getAllReady())
     return NULL;
@@ -17,7 +17,12 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "BlenderUtils.h"
 
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
 #include "../Blender/bgl.h"
 
 namespace ARTKBlender
@@ -26,24 +31,134 @@ namespace ARTKBlender
 // implementation of image data access methods
 
 ImageBufferHolder::ImageBufferHolder (PyObject * source)
-  : sourceObj(source, true), data(nullptr), dataSize(0)
+  : sourceObj(source, true), data(nullptr), dataSize(0), pitch(0), rowSize(0)
 {}
 
 ImageBufferHolder::~ImageBufferHolder (void)
 {}
 
+bool ImageBufferHolder::setRowLayout (size_t offset, ptrdiff_t rowPitch, size_t rowBytes, size_t rows)
+{
+  // rows can't overlap and they have to fit into buffer, bottom-up rows precede the first one
+  size_t distance = size_t(rowPitch < 0 ? -rowPitch : rowPitch);
+  size_t before = rowPitch < 0 ? distance * (rows - 1) : 0;
+  size_t after = rowPitch < 0 ? rowBytes : distance * (rows - 1) + rowBytes;
+  if (data == nullptr || rowSize != 0 || rows == 0 || rowBytes == 0 || distance < rowBytes ||
+      offset < before || offset + after > dataSize)
+    return false;
+  data += offset;
+  dataSize = rowBytes * rows;
+  pitch = rowPitch == ptrdiff_t(rowBytes) ? 0 : rowPitch;
+  rowSize = rowBytes;
+  return true;
+}
+
+bool ImageBufferHolder::cropRows (size_t rowBytes, size_t rows)
+{
+  // buffer without layout gets packed rows
+  if (rowSize == 0)
+    return setRowLayout(0, ptrdiff_t(rowBytes), rowBytes, rows);
+  if (data == nullptr || rowSize != rowBytes || rowSize * rows > dataSize)
+    return false;
+  dataSize = rowSize * rows;
+  return true;
+}
+
+bool ImageBufferHolder::flipRows (size_t rows)
+{
+  if (data == nullptr || rows == 0 || dataSize % rows != 0)
+    return false;
+  if (rowSize == 0)
+    rowSize = dataSize / rows;
+  ptrdiff_t rowPitch = pitch != 0 ? pitch : ptrdiff_t(rowSize);
+  data += rowPitch * ptrdiff_t(rows - 1);
+  pitch = -rowPitch == ptrdiff_t(rowSize) ? 0 : -rowPitch;
+  return true;
+}
+
+
+// OpenGL types of bgl.Buffer values
+static const int glByte = 0x1400, glUnsignedByte = 0x1401, glShort = 0x1402, glInt = 0x1404, glFloat = 0x1406,
+  glDouble = 0x140A;
+
+/// maximal number of pooled scratch buffers
+static const size_t scratchPoolLimit = 8;
+/// pool of scratch buffers for converted image data
+static std::vector<std::unique_ptr<AlignedBuffer>> scratchPool;
+/// mutex guarding pool, it's never held while waiting for other locks
+static std::mutex scratchMutex;
+
+// take scratch buffer from pool
+static std::unique_ptr<AlignedBuffer> takeScratch (void)
+{
+  std::lock_guard<std::mutex> lock(scratchMutex);
+  if (scratchPool.empty())
+    return std::unique_ptr<AlignedBuffer>(new AlignedBuffer);
+  std::unique_ptr<AlignedBuffer> scratch = std::move(scratchPool.back());
+  scratchPool.pop_back();
+  return scratch;
+}
+
+// return scratch buffer to pool
+static void returnScratch (std::unique_ptr<AlignedBuffer> & scratch)
+{
+  std::lock_guard<std::mutex> lock(scratchMutex);
+  if (scratchPool.size() < scratchPoolLimit)
+    scratchPool.push_back(std::move(scratch));
+}
+
+// convert double values normalized to [0, 1] to bytes
+static void convertDoubleToBytes (const double * src, ARUint8 * dst, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    double value = src[i] * 255.0;
+    dst[i] = !(value > 0.0) ? 0 : value >= 255.0 ? 255 : ARUint8(std::lrint(value));
+  }
+}
+
+// convert signed integer values normalized to their positive range to bytes
+template <class Value> static void convertIntToBytes (const Value * src, ARUint8 * dst, size_t count)
+{
+  const int shift = sizeof(Value) * 8 - 9;
+  for (size_t i = 0; i < count; ++i)
+    dst[i] = src[i] > 0 ? ARUint8(src[i] >> shift) : 0;
+}
 
 BlenderBufferHolder::BlenderBufferHolder (PyObject * source) : ImageBufferHolder(source)
 {
   Buffer * buffer = getPyType<Buffer>(sourceObj.get());
-  data = reinterpret_cast<ARUint8*>(buffer->buf.asbyte);
-  dataSize = 1;
-  for (size_t i = 0; i < buffer->ndimensions; ++i)
-    dataSize *= buffer->dimensions[i];
+  // size of data is number of values, which is number of bytes after conversion
+  size_t count = 1;
+  for (int i = 0; i < buffer->ndimensions; ++i)
+    count *= buffer->dimensions[i];
+  if (buffer->type == glByte || buffer->type == glUnsignedByte)
+  {
+    data = reinterpret_cast<ARUint8*>(buffer->buf.asbyte);
+    dataSize = count;
+    return;
+  }
+  // convert other types to scratch buffer
+  if (buffer->type != glShort && buffer->type != glInt && buffer->type != glFloat && buffer->type != glDouble)
+    return;
+  scratch = takeScratch();
+  data = scratch->get(count);
+  dataSize = count;
+  if (buffer->type == glFloat)
+    convertFloatToBytes(buffer->buf.asfloat, data, count);
+  else if (buffer->type == glDouble)
+    convertDoubleToBytes(buffer->buf.asdouble, data, count);
+  else if (buffer->type == glShort)
+    convertIntToBytes(buffer->buf.asshort, data, count);
+  else
+    convertIntToBytes(buffer->buf.asint, data, count);
 }
 
 BlenderBufferHolder::~BlenderBufferHolder (void)
-{}
+{
+  if (scratch)
+    returnScratch(scratch);
+}
 
 PyTypeObject * BlenderBufferHolder::bglBufferType = nullptr;
 
@@ -64,17 +179,44 @@ bool BlenderBufferHolder::isSuitable (PyObject * source)
 
 PythonBufferHolder::PythonBufferHolder (PyObject * source) : ImageBufferHolder(source)
 {
-  // get buffer from object
-  if (PyObject_GetBuffer(sourceObj.get(), &pyBuffer, PyBUF_SIMPLE) == 0)
+  // get buffer from object, it may be strided
+  pyBuffer.obj = nullptr;
+  if (PyObject_GetBuffer(sourceObj.get(), &pyBuffer, PyBUF_STRIDES) != 0)
+  {
+    PyErr_Clear();
+    return;
+  }
+  if (pyBuffer.ndim <= 1)
   {
-    data = reinterpret_cast<ARUint8*>(pyBuffer.buf);
-    dataSize = pyBuffer.len;
+    // one-dimensional buffer has to be contiguous
+    if (pyBuffer.ndim == 0 || pyBuffer.strides[0] == pyBuffer.itemsize)
+    {
+      data = reinterpret_cast<ARUint8*>(pyBuffer.buf);
+      dataSize = pyBuffer.len;
+    }
+    return;
   }
+  // rows are the first dimension, data of row have to be contiguous
+  size_t rowBytes = pyBuffer.itemsize;
+  for (int dim = pyBuffer.ndim - 1; dim > 0; --dim)
+  {
+    if (pyBuffer.strides[dim] != ptrdiff_t(rowBytes))
+      return;
+    rowBytes *= pyBuffer.shape[dim];
+  }
+  // rows may be stored bottom-up with negative stride
+  if (rowBytes == 0 || pyBuffer.shape[0] == 0 || std::abs(pyBuffer.strides[0]) < ptrdiff_t(rowBytes))
+    return;
+  data = reinterpret_cast<ARUint8*>(pyBuffer.buf);
+  dataSize = rowBytes * pyBuffer.shape[0];
+  pitch = size_t(pyBuffer.strides[0]) == rowBytes ? 0 : pyBuffer.strides[0];
+  rowSize = rowBytes;
 }
 
 PythonBufferHolder::~PythonBufferHolder (void)
 {
-  PyBuffer_Release(&pyBuffer);
+  if (pyBuffer.obj != nullptr)
+    PyBuffer_Release(&pyBuffer);
 }
 
 bool PythonBufferHolder::isSuitable (PyObject * source)
@@ -95,4 +237,24 @@ std::unique_ptr<ImageBufferHolder> getBufferHolder (PyObject * source)
   return std::unique_ptr<ImageBufferHolder>();
 }
 
+
+// bind source data to slot
+ImageBufferHolder * ImageBufferSlot::bind (PyObject * source)
+{
+  release();
+  if (BlenderBufferHolder::isSuitable(source))
+    holder = new (&storage) BlenderBufferHolder(source);
+  else if (PythonBufferHolder::isSuitable(source))
+    holder = new (&storage) PythonBufferHolder(source);
+  return holder;
+}
+
+// release held buffer
+void ImageBufferSlot::release (void)
+{
+  if (holder != nullptr)
+    holder->~ImageBufferHolder();
+  holder = nullptr;
+}
+
 }
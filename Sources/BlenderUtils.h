@@ -20,8 +20,10 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #include <Python.h>
 #include <AR/ar.h>
 #include <memory>
+#include <type_traits>
 
 #include "PyObjectHelper.h"
+#include "ImageUtils.h"
 
 namespace ARTKBlender
 {
@@ -45,7 +47,7 @@ public:
 
   /**
       Provides pointer to buffer.
-      \return pointer to image in buffer
+      \return pointer to image in buffer, i.e. to its first row
   */
   ARUint8 * getData (void) const
   {
@@ -54,21 +56,60 @@ public:
 
   /**
       Provides size of buffer.
-      \return size of buffer in bytes
+      \return size of buffer in bytes, for buffer with row layout size of its rows
   */
   size_t getSize (void) const
   {
       return dataSize;
   }
 
+  /**
+      Provides distance of rows in buffer.
+      \return distance of starts of rows in bytes, negative for bottom-up rows, 0 if rows are packed
+  */
+  ptrdiff_t getPitch (void) const
+  {
+    return pitch;
+  }
+
+  /**
+      Applies layout of rows to buffer without layout of rows, i.e. to buffer
+      of packed image or to one-dimensional buffer.
+      \param offset   offset of the first row in bytes
+      \param rowPitch distance of starts of rows in bytes, negative if rows are stored bottom-up
+      \param rowBytes size of row in bytes
+      \param rows     number of rows
+      \return true, if rows are inside of buffer
+  */
+  bool setRowLayout (size_t offset, ptrdiff_t rowPitch, size_t rowBytes, size_t rows);
+
+  /**
+      Restricts buffer to its leading rows, e.g. to luminance plane of planar
+      YUV image followed by chroma planes. Image data aren't copied.
+      \param rowBytes size of row in bytes
+      \param rows     number of leading rows
+      \return true, if rows are inside of buffer
+  */
+  bool cropRows (size_t rowBytes, size_t rows);
+
+  /**
+      Reverses order of rows, so the last row of buffer becomes the first one.
+      Image data aren't copied, only pitch of rows is negated.
+      \param rows number of rows
+      \return true, if size of buffer is multiple of rows
+  */
+  bool flipRows (size_t rows);
+
   /**
       Validates buffer and its size.
-      \param required data size, if 0, size is not checked.
+      \param reqSize required data size, if 0, size is not checked.
+      \param reqRows required number of rows, rows with pitch are rejected, if 0
       \return true, if buffer is valid and has required size.
   */
-  bool isValid (size_t reqSize) const
+  bool isValid (size_t reqSize, size_t reqRows = 0) const
   {
-    return data != nullptr && (dataSize == reqSize || reqSize == 0);
+    return data != nullptr && (dataSize == reqSize || reqSize == 0) &&
+      (pitch == 0 || (reqRows != 0 && rowSize * reqRows == dataSize));
   }
   
 protected:
@@ -78,11 +119,18 @@ protected:
   ARUint8 * data;
   /// size of image data
   size_t dataSize;
+  /// distance of rows in bytes, 0 for packed rows
+  ptrdiff_t pitch;
+  /// size of row in bytes, 0 if buffer has no layout of rows
+  size_t rowSize;
 };
 
 
 /**
-    Class holding image buffer from Blender's bgl.Buffer.
+    Class holding image buffer from Blender's bgl.Buffer. Byte buffers are used
+    directly, values of other types are converted to 8-bit values in pooled
+    scratch buffer: floating point values are normalized to [0, 1], integer
+    values to their positive range, as OpenGL returns them.
 */
 class BlenderBufferHolder : public ImageBufferHolder
 {
@@ -106,11 +154,15 @@ public:
 protected:
   /// pointer to bgl.Buffer type
   static PyTypeObject * bglBufferType;
+  /// scratch buffer with converted values, null for byte buffers
+  std::unique_ptr<AlignedBuffer> scratch;
 };
 
     
 /**
-    Class holding python's buffer.
+    Class holding python's buffer. Multi-dimensional buffers are accepted with
+    any distance of rows given by stride of the first dimension, if data of
+    every row are contiguous.
 */
 class PythonBufferHolder : public ImageBufferHolder
 {
@@ -144,4 +196,58 @@ protected:
 */
 std::unique_ptr<ImageBufferHolder> getBufferHolder (PyObject * source);
 
+
+/**
+    Storage of buffer holder reused for image data of successive calls, the
+    holder is constructed in place, so binding of image doesn't allocate.
+*/
+class ImageBufferSlot
+{
+public:
+  /**
+      Constructor creates empty slot.
+  */
+  ImageBufferSlot (void) : holder(nullptr)
+  {}
+
+  /**
+      Destructor releases held buffer.
+  */
+  ~ImageBufferSlot (void)
+  {
+    release();
+  }
+
+  ImageBufferSlot (const ImageBufferSlot &) = delete;
+  ImageBufferSlot & operator= (const ImageBufferSlot &) = delete;
+
+  /**
+      Creates appropriate type of buffer holder for source data in slot,
+      buffer held previously is released.
+      \param source source python object
+      \return pointer to image holder, null if source has no buffer
+  */
+  ImageBufferHolder * bind (PyObject * source);
+
+  /**
+      Releases held buffer.
+  */
+  void release (void);
+
+  /**
+      Provides held buffer.
+      \return pointer to image holder, null if slot is empty
+  */
+  ImageBufferHolder * get (void) const
+  {
+    return holder;
+  }
+
+protected:
+  /// storage of holder
+  std::aligned_union<0, BlenderBufferHolder, PythonBufferHolder>::type storage;
+  /// holder constructed in storage, null if slot is empty
+  ImageBufferHolder * holder;
+};
+
 }
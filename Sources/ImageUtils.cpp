@@ -0,0 +1,564 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ImageUtils.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define ARTK_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX2 kernels are compiled for x86 targets and selected at runtime
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ARTK_USE_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ARTK_AVX2_FUNCTION
+#else
+#define ARTK_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace ARTKBlender
+{
+
+// luminance of color components, weights sum to 256 to get their average
+static inline ARUint8 lumaOf (int c0, int c1, int c2)
+{
+  return ARUint8((c0 * 85 + c1 * 86 + c2 * 85) >> 8);
+}
+
+// read 16-bit pixel
+static inline unsigned short readPixel16 (const ARUint8 * src)
+{
+  unsigned short value;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+#ifdef ARTK_USE_SSE2
+// convert 16 pixels with 4 bytes per pixel to luminance, weights are 16-bit values for each byte of pixel
+static inline __m128i lumaOf16Pixels (const ARUint8 * src, __m128i weights)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sums[4];
+  for (int i = 0; i < 4; ++i)
+  {
+    // weighted sums of pixel component pairs
+    __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), weights);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), weights);
+    // add pairs of every pixel
+    __m128 loF = _mm_castsi128_ps(lo), hiF = _mm_castsi128_ps(hi);
+    __m128i first = _mm_castps_si128(_mm_shuffle_ps(loF, hiF, _MM_SHUFFLE(2, 0, 2, 0)));
+    __m128i second = _mm_castps_si128(_mm_shuffle_ps(loF, hiF, _MM_SHUFFLE(3, 1, 3, 1)));
+    sums[i] = _mm_srli_epi32(_mm_add_epi32(first, second), 8);
+  }
+  return _mm_packus_epi16(_mm_packs_epi32(sums[0], sums[1]), _mm_packs_epi32(sums[2], sums[3]));
+}
+#endif
+
+#ifdef ARTK_USE_AVX2
+// check processor and operating system support of AVX2
+static bool detectAVX2 (void)
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  // OSXSAVE and AVX, then saved state of YMM registers
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+// convert 32 pixels with 4 bytes per pixel, in 4 vectors of 8 pixels, to luminance
+ARTK_AVX2_FUNCTION static inline __m256i lumaOf32Pixels (const __m256i pixels[4], __m256i weights)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i sums[4];
+  for (int i = 0; i < 4; ++i)
+  {
+    // weighted sums of component pairs, pixels stay ordered within lanes after horizontal add
+    __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(pixels[i], zero), weights);
+    __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(pixels[i], zero), weights);
+    sums[i] = _mm256_srli_epi32(_mm256_hadd_epi32(lo, hi), 8);
+  }
+  // packing interleaves groups of 4 pixels of lanes, permutation restores their order
+  __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(sums[0], sums[1]), _mm256_packs_epi32(sums[2], sums[3]));
+  return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+// convert start of row to luminance by AVX2, return number of converted pixels
+ARTK_AVX2_FUNCTION static int convertRowToLumaAVX2 (const ARUint8 * src, ARUint8 * dst, int width,
+  AR_PIXEL_FORMAT pixelFormat)
+{
+  int x = 0;
+  switch (pixelFormat)
+  {
+  case AR_PIXEL_FORMAT_RGB:
+  case AR_PIXEL_FORMAT_BGR:
+  {
+    // 4 pixels of every lane are expanded to 4 bytes, loads read 4 bytes past 8 pixels
+    const __m128i expand128 = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i expand = _mm256_inserti128_si256(_mm256_castsi128_si256(expand128), expand128, 1);
+    const __m256i weights = _mm256_setr_epi16(85, 86, 85, 0, 85, 86, 85, 0, 85, 86, 85, 0, 85, 86, 85, 0);
+    for (; x + 34 <= width; x += 32, src += 96)
+    {
+      __m256i pixels[4];
+      for (int i = 0; i < 4; ++i)
+      {
+        const ARUint8 * part = src + i * 24;
+        __m256i loaded = _mm256_inserti128_si256(
+          _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(part))),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(part + 12)), 1);
+        pixels[i] = _mm256_shuffle_epi8(loaded, expand);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), lumaOf32Pixels(pixels, weights));
+    }
+    break;
+  }
+
+  case AR_PIXEL_FORMAT_RGBA:
+  case AR_PIXEL_FORMAT_BGRA:
+  case AR_PIXEL_FORMAT_ABGR:
+  case AR_PIXEL_FORMAT_ARGB:
+  {
+    const __m256i weights = pixelFormat == AR_PIXEL_FORMAT_RGBA || pixelFormat == AR_PIXEL_FORMAT_BGRA
+      ? _mm256_setr_epi16(85, 86, 85, 0, 85, 86, 85, 0, 85, 86, 85, 0, 85, 86, 85, 0)
+      : _mm256_setr_epi16(0, 85, 86, 85, 0, 85, 86, 85, 0, 85, 86, 85, 0, 85, 86, 85);
+    for (; x + 32 <= width; x += 32, src += 128)
+    {
+      __m256i pixels[4];
+      for (int i = 0; i < 4; ++i)
+        pixels[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 32));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), lumaOf32Pixels(pixels, weights));
+    }
+    break;
+  }
+
+  case AR_PIXEL_FORMAT_2vuy:
+  case AR_PIXEL_FORMAT_yuvs:
+  {
+    // luminance is every second byte, packing interleaves 64-bit parts of lanes
+    const __m256i mask = _mm256_set1_epi16(0x00FF);
+    for (; x + 32 <= width; x += 32, src += 64)
+    {
+      __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+      __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+      if (pixelFormat == AR_PIXEL_FORMAT_2vuy)
+      {
+        lo = _mm256_srli_epi16(lo, 8);
+        hi = _mm256_srli_epi16(hi, 8);
+      }
+      else
+      {
+        lo = _mm256_and_si256(lo, mask);
+        hi = _mm256_and_si256(hi, mask);
+      }
+      __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), packed);
+    }
+    break;
+  }
+
+  default:
+    break;
+  }
+  return x;
+}
+
+// convert start of normalized float values to bytes by AVX2, return number of converted values
+ARTK_AVX2_FUNCTION static size_t convertFloatToBytesAVX2 (const float * src, ARUint8 * dst, size_t count)
+{
+  const __m256 scale = _mm256_set1_ps(255.0f);
+  size_t i = 0;
+  for (; i + 32 <= count; i += 32)
+  {
+    __m256i values[4];
+    for (int j = 0; j < 4; ++j)
+      values[j] = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + j * 8), scale));
+    // saturating packs clamp values, packing interleaves groups of 4 values of lanes
+    __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(values[0], values[1]),
+      _mm256_packs_epi32(values[2], values[3]));
+    packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+  }
+  return i;
+}
+#endif
+
+// check availability of AVX2 kernels
+bool isAVX2Available (void)
+{
+#ifdef ARTK_USE_AVX2
+  static const bool available = detectAVX2();
+  return available;
+#else
+  return false;
+#endif
+}
+
+// check for luminance formats
+bool isLumaFormat (AR_PIXEL_FORMAT pixelFormat)
+{
+  return pixelFormat == AR_PIXEL_FORMAT_MONO || pixelFormat == AR_PIXEL_FORMAT_420v ||
+    pixelFormat == AR_PIXEL_FORMAT_420f || pixelFormat == AR_PIXEL_FORMAT_NV21;
+}
+
+// convert row to luminance
+void convertRowToLuma (const ARUint8 * src, ARUint8 * dst, int width, AR_PIXEL_FORMAT pixelFormat)
+{
+  int x = 0;
+#ifdef ARTK_USE_AVX2
+  // AVX2 converts most of row, the rest is converted by following code
+  if (isAVX2Available() && !isLumaFormat(pixelFormat))
+  {
+    x = convertRowToLumaAVX2(src, dst, width, pixelFormat);
+    src += size_t(x) * arUtilGetPixelSize(pixelFormat);
+  }
+#endif
+  switch (pixelFormat)
+  {
+  case AR_PIXEL_FORMAT_RGB:
+  case AR_PIXEL_FORMAT_BGR:
+    for (; x < width; ++x, src += 3)
+      dst[x] = lumaOf(src[0], src[1], src[2]);
+    break;
+
+  case AR_PIXEL_FORMAT_RGBA:
+  case AR_PIXEL_FORMAT_BGRA:
+  case AR_PIXEL_FORMAT_ABGR:
+  case AR_PIXEL_FORMAT_ARGB:
+  {
+    // position of alpha component
+    const int alpha = pixelFormat == AR_PIXEL_FORMAT_RGBA || pixelFormat == AR_PIXEL_FORMAT_BGRA ? 3 : 0;
+#ifdef ARTK_USE_SSE2
+    const __m128i weights = alpha == 3 ? _mm_setr_epi16(85, 86, 85, 0, 85, 86, 85, 0)
+      : _mm_setr_epi16(0, 85, 86, 85, 0, 85, 86, 85);
+    for (; x + 16 <= width; x += 16, src += 64)
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), lumaOf16Pixels(src, weights));
+#endif
+    const int first = alpha == 3 ? 0 : 1;
+    for (; x < width; ++x, src += 4)
+      dst[x] = lumaOf(src[first], src[first + 1], src[first + 2]);
+    break;
+  }
+
+  case AR_PIXEL_FORMAT_2vuy:
+  case AR_PIXEL_FORMAT_yuvs:
+  {
+    // luminance is every second byte
+    const int offset = pixelFormat == AR_PIXEL_FORMAT_2vuy ? 1 : 0;
+#ifdef ARTK_USE_SSE2
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    for (; x + 16 <= width; x += 16, src += 32)
+    {
+      __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+      if (offset == 1)
+      {
+        lo = _mm_srli_epi16(lo, 8);
+        hi = _mm_srli_epi16(hi, 8);
+      }
+      else
+      {
+        lo = _mm_and_si128(lo, mask);
+        hi = _mm_and_si128(hi, mask);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; x < width; ++x, src += 2)
+      dst[x] = src[offset];
+    break;
+  }
+
+  case AR_PIXEL_FORMAT_RGB_565:
+    for (; x < width; ++x, src += 2)
+    {
+      unsigned short value = readPixel16(src);
+      int r = (value >> 11) & 0x1F, g = (value >> 5) & 0x3F, b = value & 0x1F;
+      dst[x] = lumaOf((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+    }
+    break;
+
+  case AR_PIXEL_FORMAT_RGBA_5551:
+    for (; x < width; ++x, src += 2)
+    {
+      unsigned short value = readPixel16(src);
+      int r = (value >> 11) & 0x1F, g = (value >> 6) & 0x1F, b = (value >> 1) & 0x1F;
+      dst[x] = lumaOf((r << 3) | (r >> 2), (g << 3) | (g >> 2), (b << 3) | (b >> 2));
+    }
+    break;
+
+  case AR_PIXEL_FORMAT_RGBA_4444:
+    for (; x < width; ++x, src += 2)
+    {
+      unsigned short value = readPixel16(src);
+      dst[x] = lumaOf(((value >> 12) & 0xF) * 17, ((value >> 8) & 0xF) * 17, ((value >> 4) & 0xF) * 17);
+    }
+    break;
+
+  default:
+    // luminance formats
+    std::memcpy(dst + x, src, width - x);
+    break;
+  }
+}
+
+// convert image to luminance
+void convertToLuma (const ARUint8 * src, ARUint8 * dst, int xsize, int ysize, AR_PIXEL_FORMAT pixelFormat,
+  ptrdiff_t srcPitch)
+{
+  const size_t rowSize = size_t(xsize) * (isLumaFormat(pixelFormat) ? 1 : arUtilGetPixelSize(pixelFormat));
+  // packed luminance plane is copied at once
+  if (isLumaFormat(pixelFormat) && (srcPitch == 0 || size_t(srcPitch) == rowSize))
+  {
+    std::memcpy(dst, src, size_t(xsize) * ysize);
+    return;
+  }
+  if (srcPitch == 0)
+    srcPitch = ptrdiff_t(rowSize);
+  for (int y = 0; y < ysize; ++y, src += srcPitch, dst += xsize)
+    convertRowToLuma(src, dst, xsize, pixelFormat);
+}
+
+// copy rows to packed image
+void packRows (const ARUint8 * src, ptrdiff_t srcPitch, ARUint8 * dst, size_t rowSize, int rows)
+{
+  for (int y = 0; y < rows; ++y, src += srcPitch, dst += rowSize)
+    std::memcpy(dst, src, rowSize);
+}
+
+// convert normalized float values to bytes
+void convertFloatToBytes (const float * src, ARUint8 * dst, size_t count)
+{
+  size_t i = 0;
+#ifdef ARTK_USE_AVX2
+  if (isAVX2Available())
+    i = convertFloatToBytesAVX2(src, dst, count);
+#endif
+#ifdef ARTK_USE_SSE2
+  const __m128 scale = _mm_set1_ps(255.0f);
+  for (; i + 16 <= count; i += 16)
+  {
+    __m128i values[4];
+    for (int j = 0; j < 4; ++j)
+      values[j] = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(src + i + j * 4), scale));
+    // saturating packs clamp values
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(values[0], values[1]), _mm_packs_epi32(values[2], values[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+  }
+#endif
+  // rounding to nearest even matches conversion of SIMD kernels, NaN gives 0
+  for (; i < count; ++i)
+  {
+    float value = src[i] * 255.0f;
+    dst[i] = !(value > 0.0f) ? 0 : value >= 255.0f ? 255 : ARUint8(std::lrint(value));
+  }
+}
+
+// downsample luminance to half size
+void halveLuma (const ARUint8 * src, int xsize, int ysize, ARUint8 * dst)
+{
+  const int dstXSize = xsize / 2, dstYSize = ysize / 2;
+  for (int y = 0; y < dstYSize; ++y, dst += dstXSize)
+  {
+    const ARUint8 * row0 = src + size_t(2 * y) * xsize;
+    const ARUint8 * row1 = row0 + xsize;
+    int x = 0;
+#ifdef ARTK_USE_SSE2
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    const __m128i round = _mm_set1_epi16(2);
+    for (; x + 16 <= dstXSize; x += 16)
+    {
+      // 16 bit sums of even and odd columns of both rows, rounded as scalar code
+      __m128i sums[2];
+      for (int i = 0; i < 2; ++i)
+      {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x + 16 * i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x + 16 * i));
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(_mm_and_si128(a, mask), _mm_srli_epi16(a, 8)),
+          _mm_add_epi16(_mm_and_si128(b, mask), _mm_srli_epi16(b, 8)));
+        sums[i] = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(sums[0], sums[1]));
+    }
+#endif
+    for (; x < dstXSize; ++x)
+      dst[x] = ARUint8((row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1] + 2) >> 2);
+  }
+}
+
+// compute automatic labeling threshold
+int computeAutoThreshold (const ARUint8 * image, int xsize, int ysize, AR_PIXEL_FORMAT pixelFormat,
+  AR_LABELING_THRESH_MODE mode)
+{
+  // histogram of luminance, rows of color formats are converted first
+  unsigned long long hist[256] = { 0 };
+  const size_t rowSize = size_t(xsize) * (isLumaFormat(pixelFormat) ? 1 : arUtilGetPixelSize(pixelFormat));
+  std::vector<ARUint8> row(isLumaFormat(pixelFormat) ? 0 : xsize);
+  for (int y = 0; y < ysize; ++y, image += rowSize)
+  {
+    const ARUint8 * luma = image;
+    if (!row.empty())
+    {
+      convertRowToLuma(image, row.data(), xsize, pixelFormat);
+      luma = row.data();
+    }
+    for (int x = 0; x < xsize; ++x)
+      ++hist[luma[x]];
+  }
+  const unsigned long long total = (unsigned long long)xsize * ysize;
+
+  // median is in the middle of values with cumulative count equal to half of pixels
+  if (mode == AR_LABELING_THRESH_MODE_AUTO_MEDIAN)
+  {
+    const unsigned long long required = total / 2;
+    int i = 0;
+    unsigned long long cdf = hist[0];
+    while (i < 255 && cdf < required)
+      cdf += hist[++i];
+    int j = i;
+    while (j < 255 && cdf == required)
+      cdf += hist[++j];
+    return (i + j) / 2;
+  }
+
+  // Otsu's threshold maximizes variance between background and foreground
+  double sum = 0.0;
+  for (int i = 0; i < 256; ++i)
+    sum += double(i) * hist[i];
+  double sumB = 0.0, varMax = 0.0;
+  unsigned long long wB = 0;
+  int threshold = 0;
+  for (int i = 0; i < 256; ++i)
+  {
+    wB += hist[i];
+    if (wB == 0)
+      continue;
+    const unsigned long long wF = total - wB;
+    if (wF == 0)
+      break;
+    sumB += double(i) * hist[i];
+    const double mB = sumB / wB, mF = (sum - sumB) / wF;
+    const double varBetween = double(wB) * double(wF) * (mB - mF) * (mB - mF);
+    if (varBetween > varMax)
+    {
+      varMax = varBetween;
+      threshold = i;
+    }
+  }
+  return threshold;
+}
+
+// compute sum of absolute differences of blocks
+unsigned long long sumAbsDiff (const ARUint8 * first, const ARUint8 * second, size_t pitch, size_t rowSize, int rows)
+{
+  unsigned long long sum = 0;
+  for (int y = 0; y < rows; ++y, first += pitch, second += pitch)
+  {
+    size_t x = 0;
+#ifdef ARTK_USE_SSE2
+    // every instruction sums differences of 16 bytes to two 64-bit lanes
+    __m128i sums = _mm_setzero_si128();
+    for (; x + 16 <= rowSize; x += 16)
+      sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + x)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + x))));
+    unsigned long long lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sums);
+    sum += lanes[0] + lanes[1];
+#endif
+    for (; x < rowSize; ++x)
+      sum += first[x] > second[x] ? first[x] - second[x] : second[x] - first[x];
+  }
+  return sum;
+}
+
+// primes of fingerprint rounds
+static const unsigned long long fingerprintPrime1 = 0x9E3779B185EBCA87ULL, fingerprintPrime2 = 0xC2B2AE3D27D4EB4FULL,
+  fingerprintPrime3 = 0x165667B19E3779F9ULL;
+
+// mix value into lane of fingerprint
+static inline unsigned long long fingerprintRound (unsigned long long lane, unsigned long long value)
+{
+  lane += value * fingerprintPrime2;
+  lane = (lane << 31) | (lane >> 33);
+  return lane * fingerprintPrime1;
+}
+
+// compute fingerprint of image
+unsigned long long computeFingerprint (const ARUint8 * src, ptrdiff_t pitch, size_t rowSize, int rows,
+  unsigned long long seed)
+{
+  // packed rows are processed as one row
+  if (pitch == 0)
+  {
+    rowSize *= size_t(rows);
+    rows = 1;
+  }
+  // four independent lanes hide latency of multiplications
+  unsigned long long lanes[4] = { seed + fingerprintPrime1 + fingerprintPrime2, seed + fingerprintPrime2, seed,
+    seed - fingerprintPrime1 };
+  unsigned long long words[4];
+  for (int y = 0; y < rows; ++y, src += pitch)
+  {
+    const ARUint8 * row = src;
+    size_t rest = rowSize;
+    for (; rest >= sizeof(words); rest -= sizeof(words), row += sizeof(words))
+    {
+      std::memcpy(words, row, sizeof(words));
+      for (int i = 0; i < 4; ++i)
+        lanes[i] = fingerprintRound(lanes[i], words[i]);
+    }
+    // the rest of row is padded by zeros
+    if (rest > 0)
+    {
+      std::memset(words, 0, sizeof(words));
+      std::memcpy(words, row, rest);
+      for (int i = 0; i < 4; ++i)
+        lanes[i] = fingerprintRound(lanes[i], words[i]);
+    }
+  }
+  // merge lanes and avalanche bits
+  unsigned long long result = rowSize * size_t(rows);
+  for (int i = 0; i < 4; ++i)
+    result = fingerprintRound(result ^ lanes[i], lanes[i]) * fingerprintPrime1 + fingerprintPrime3;
+  result ^= result >> 33;
+  result *= fingerprintPrime2;
+  result ^= result >> 29;
+  return result != 0 ? result : 1;
+}
+
+}
@@ -0,0 +1,163 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/**
+    Image processing kernels working on 8-bit image data.
+    Luminance of color pixels is average of their color components, as used
+    by ARToolKit's labeling.
+*/
+
+/**
+    Reusable image buffer aligned to cache line, its capacity only grows.
+*/
+class AlignedBuffer
+{
+public:
+  /// alignment of buffer in bytes
+  static const size_t alignment = 64;
+
+  /**
+      Provides buffer of required size, content of previous buffer isn't kept.
+      \param size size of buffer in bytes
+      \return pointer to aligned buffer
+  */
+  ARUint8 * get (size_t size)
+  {
+    if (storage.size() < size + alignment)
+      storage.resize(size + alignment);
+    size_t address = reinterpret_cast<size_t>(storage.data());
+    return storage.data() + (alignment - address % alignment) % alignment;
+  }
+
+protected:
+  /// storage of buffer with space for alignment
+  std::vector<ARUint8> storage;
+};
+
+/**
+    Checks if processor supports AVX2 kernels, they are selected at runtime.
+    \return true, if AVX2 kernels are used
+*/
+bool isAVX2Available (void);
+
+/**
+    Checks if pixel format stores luminance plane at start of image data.
+    \param pixelFormat pixel format
+    \return true, for MONO and planar YUV formats
+*/
+bool isLumaFormat (AR_PIXEL_FORMAT pixelFormat);
+
+/**
+    Converts row of pixels to luminance.
+    \param src         source pixels
+    \param dst         destination luminance values
+    \param width       number of pixels
+    \param pixelFormat format of source pixels
+*/
+void convertRowToLuma (const ARUint8 * src, ARUint8 * dst, int width, AR_PIXEL_FORMAT pixelFormat);
+
+/**
+    Converts image to luminance plane.
+    \param src         source image
+    \param dst         destination luminance plane of xsize * ysize bytes
+    \param xsize       width of image
+    \param ysize       height of image
+    \param pixelFormat format of source pixels
+    \param srcPitch    distance of source rows in bytes, 0 for packed rows
+*/
+void convertToLuma (const ARUint8 * src, ARUint8 * dst, int xsize, int ysize, AR_PIXEL_FORMAT pixelFormat,
+  ptrdiff_t srcPitch = 0);
+
+/**
+    Copies rows of image to packed image.
+    \param src      source image
+    \param srcPitch distance of source rows in bytes
+    \param dst      destination image of rowSize * rows bytes
+    \param rowSize  size of row in bytes
+    \param rows     number of rows
+*/
+void packRows (const ARUint8 * src, ptrdiff_t srcPitch, ARUint8 * dst, size_t rowSize, int rows);
+
+/**
+    Converts normalized float values to 8-bit values, values are clamped to [0, 1]
+    and scaled to [0, 255] with rounding.
+    \param src   source values
+    \param dst   destination values
+    \param count number of values
+*/
+void convertFloatToBytes (const float * src, ARUint8 * dst, size_t count);
+
+/**
+    Downsamples luminance plane to half size by averaging of 2x2 blocks.
+    \param src   source luminance plane
+    \param xsize width of source plane
+    \param ysize height of source plane
+    \param dst   destination luminance plane of (xsize / 2) * (ysize / 2) bytes
+*/
+void halveLuma (const ARUint8 * src, int xsize, int ysize, ARUint8 * dst);
+
+/**
+    Computes labeling threshold from luminance histogram of image, as ARToolKit
+    does in automatic threshold modes.
+    \param image       image data
+    \param xsize       width of image
+    \param ysize       height of image
+    \param pixelFormat format of image data
+    \param mode        threshold mode, AR_LABELING_THRESH_MODE_AUTO_MEDIAN or AR_LABELING_THRESH_MODE_AUTO_OTSU
+    \return median of luminance or threshold maximizing Otsu's between-class variance
+*/
+int computeAutoThreshold (const ARUint8 * image, int xsize, int ysize, AR_PIXEL_FORMAT pixelFormat,
+  AR_LABELING_THRESH_MODE mode);
+
+/**
+    Computes sum of absolute differences of two blocks of image data.
+    \param first   first block
+    \param second  second block
+    \param pitch   distance of rows of both blocks in bytes
+    \param rowSize size of row in bytes
+    \param rows    number of rows
+    \return sum of absolute differences of bytes
+*/
+unsigned long long sumAbsDiff (const ARUint8 * first, const ARUint8 * second, size_t pitch, size_t rowSize, int rows);
+
+/**
+    Computes 64-bit fingerprint of image data, every byte of rows affects it.
+    \param src     image data
+    \param pitch   distance of rows in bytes, 0 for packed rows
+    \param rowSize size of row in bytes
+    \param rows    number of rows
+    \param seed    initial value, e.g. fingerprint of settings used with image
+    \return fingerprint of image, never 0
+*/
+unsigned long long computeFingerprint (const ARUint8 * src, ptrdiff_t pitch, size_t rowSize, int rows,
+  unsigned long long seed);
+
+}
@@ -0,0 +1,98 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ARTKBlender
+{
+
+#ifdef _WIN32
+
+// map file
+MappedFile::MappedFile (const char * fileName) : data(nullptr), size(0), fileHandle(INVALID_HANDLE_VALUE),
+  mappingHandle(nullptr)
+{
+  // deletion is shared, so snapshot can be replaced while it's mapped
+  fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL, NULL);
+  LARGE_INTEGER fileSize;
+  if (fileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    return;
+  mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mappingHandle == nullptr)
+    return;
+  data = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+  if (data != nullptr)
+    size = size_t(fileSize.QuadPart);
+}
+
+// unmap file
+MappedFile::~MappedFile (void)
+{
+  if (data != nullptr)
+    UnmapViewOfFile(data);
+  if (mappingHandle != nullptr)
+    CloseHandle(mappingHandle);
+  if (fileHandle != INVALID_HANDLE_VALUE)
+    CloseHandle(fileHandle);
+}
+
+#else
+
+// map file
+MappedFile::MappedFile (const char * fileName) : data(nullptr), size(0)
+{
+  int file = open(fileName, O_RDONLY);
+  if (file < 0)
+    return;
+  // mapping stays valid after file is closed
+  struct stat fileStat;
+  if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+  {
+    void * mapped = mmap(nullptr, size_t(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+    if (mapped != MAP_FAILED)
+    {
+      data = mapped;
+      size = size_t(fileStat.st_size);
+    }
+  }
+  close(file);
+}
+
+// unmap file
+MappedFile::~MappedFile (void)
+{
+  if (data != nullptr)
+    munmap(const_cast<void*>(data), size);
+}
+
+#endif
+
+}
@@ -0,0 +1,90 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+
+namespace ARTKBlender
+{
+
+/**
+    Read only memory mapping of whole file. Pages of file are loaded on demand
+    and shared by all processes mapping the same file.
+*/
+class MappedFile
+{
+public:
+  /**
+      Constructor maps file.
+      \param fileName name of file
+  */
+  MappedFile (const char * fileName);
+
+  /**
+      Destructor unmaps file.
+  */
+  ~MappedFile (void);
+
+  /**
+      Checks if file is mapped.
+      \return true, if file is mapped
+  */
+  bool isValid (void) const
+  {
+    return data != nullptr;
+  }
+
+  /**
+      Provides mapped data.
+      \return pointer to data of file
+  */
+  const void * getData (void) const
+  {
+    return data;
+  }
+
+  /**
+      Provides size of mapped data.
+      \return size of file in bytes
+  */
+  size_t getSize (void) const
+  {
+    return size;
+  }
+
+protected:
+  /// mapped data
+  const void * data;
+  /// size of mapped data
+  size_t size;
+#ifdef _WIN32
+  /// handle of file
+  void * fileHandle;
+  /// handle of file mapping
+  void * mappingHandle;
+#endif
+
+  MappedFile (const MappedFile &) = delete;
+  MappedFile & operator= (const MappedFile &) = delete;
+};
+
+}
@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "MatrixUtils.h"
+
+#include "PyObjectHelper.h"
+#include "BlenderUtils.h"
+#include "../Blender/bgl.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace ARTKBlender
+{
+
+// convert ARToolKit matrix to Blender matrix
+void toBlenderMatrix (const ARdouble conv[3][4], double mat[4][4])
+{
+  for (int j = 0; j < 4; ++j)
+  {
+    mat[0][j] = conv[0][j];
+    mat[1][j] = -conv[1][j];
+    mat[2][j] = -conv[2][j];
+    mat[3][j] = j < 3 ? 0.0 : 1.0;
+  }
+}
+
+// convert Blender matrix to ARToolKit matrix
+void fromBlenderMatrix (const double mat[4][4], ARdouble conv[3][4])
+{
+  for (int j = 0; j < 4; ++j)
+  {
+    conv[0][j] = mat[0][j];
+    conv[1][j] = -mat[1][j];
+    conv[2][j] = -mat[2][j];
+  }
+}
+
+// build tuple from matrix
+PyObject * buildMatrixTuple (const double mat[4][4])
+{
+  return Py_BuildValue("((dddd)(dddd)(dddd)(dddd))", mat[0][0], mat[0][1], mat[0][2], mat[0][3],
+    mat[1][0], mat[1][1], mat[1][2], mat[1][3], mat[2][0], mat[2][1], mat[2][2], mat[2][3],
+    mat[3][0], mat[3][1], mat[3][2], mat[3][3]);
+}
+
+// parse matrix from tuple
+bool parseMatrixTuple (PyObject * value, double mat[4][4])
+{
+  return PyArg_ParseTuple(value, "(dddd)(dddd)(dddd)(dddd)",
+    &mat[0][0], &mat[0][1], &mat[0][2], &mat[0][3], &mat[1][0], &mat[1][1], &mat[1][2], &mat[1][3],
+    &mat[2][0], &mat[2][1], &mat[2][2], &mat[2][3], &mat[3][0], &mat[3][1], &mat[3][2], &mat[3][3]) != 0;
+}
+
+// create buffer for matrices
+PyObject * createMatrixBuffer (Py_ssize_t count)
+{
+  PyObjectOwner data(PyByteArray_FromStringAndSize(NULL, count * 16 * sizeof(double)));
+  if (data.isNull())
+    return nullptr;
+  PyObjectOwner view(PyMemoryView_FromObject(data.get()));
+  if (view.isNull())
+    return nullptr;
+  // memoryview can't have zero in shape
+  if (count == 0)
+    return PyObject_CallMethod(view.get(), "cast", "s", "d");
+  return PyObject_CallMethod(view.get(), "cast", "s(nii)", "d", count, 4, 4);
+}
+
+// get buffer with matrices
+bool getMatrixBuffer (PyObject * obj, Py_buffer * buffer, Py_ssize_t count, bool writable)
+{
+  if (PyObject_GetBuffer(obj, buffer, (writable ? PyBUF_WRITABLE : 0) | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+    return false;
+  if (buffer->len != Py_ssize_t(count * 16 * sizeof(double)) || buffer->itemsize != sizeof(double) ||
+    (buffer->format != NULL && std::strcmp(buffer->format, "d") != 0 && std::strcmp(buffer->format, "@d") != 0))
+  {
+    PyBuffer_Release(buffer);
+    PyErr_SetString(PyExc_ValueError, "Buffer has to be contiguous float64 buffer with 16 values per matrix");
+    return false;
+  }
+  return true;
+}
+
+// convert rotation to quaternion
+void matrixToQuaternion (const double mat[4][4], double quat[4])
+{
+  // use the largest component to avoid division by small number
+  double trace = mat[0][0] + mat[1][1] + mat[2][2];
+  if (trace > 0.0)
+  {
+    double s = 0.5 / std::sqrt(trace + 1.0);
+    quat[0] = 0.25 / s;
+    quat[1] = (mat[2][1] - mat[1][2]) * s;
+    quat[2] = (mat[0][2] - mat[2][0]) * s;
+    quat[3] = (mat[1][0] - mat[0][1]) * s;
+  }
+  else if (mat[0][0] > mat[1][1] && mat[0][0] > mat[2][2])
+  {
+    double s = 2.0 * std::sqrt(1.0 + mat[0][0] - mat[1][1] - mat[2][2]);
+    quat[0] = (mat[2][1] - mat[1][2]) / s;
+    quat[1] = 0.25 * s;
+    quat[2] = (mat[0][1] + mat[1][0]) / s;
+    quat[3] = (mat[0][2] + mat[2][0]) / s;
+  }
+  else if (mat[1][1] > mat[2][2])
+  {
+    double s = 2.0 * std::sqrt(1.0 + mat[1][1] - mat[0][0] - mat[2][2]);
+    quat[0] = (mat[0][2] - mat[2][0]) / s;
+    quat[1] = (mat[0][1] + mat[1][0]) / s;
+    quat[2] = 0.25 * s;
+    quat[3] = (mat[1][2] + mat[2][1]) / s;
+  }
+  else
+  {
+    double s = 2.0 * std::sqrt(1.0 + mat[2][2] - mat[0][0] - mat[1][1]);
+    quat[0] = (mat[1][0] - mat[0][1]) / s;
+    quat[1] = (mat[0][2] + mat[2][0]) / s;
+    quat[2] = (mat[1][2] + mat[2][1]) / s;
+    quat[3] = 0.25 * s;
+  }
+}
+
+// convert quaternion to rotation
+void quaternionToMatrix (const double quat[4], double mat[4][4])
+{
+  const double w = quat[0], x = quat[1], y = quat[2], z = quat[3];
+  mat[0][0] = 1.0 - 2.0 * (y * y + z * z);
+  mat[0][1] = 2.0 * (x * y - w * z);
+  mat[0][2] = 2.0 * (x * z + w * y);
+  mat[1][0] = 2.0 * (x * y + w * z);
+  mat[1][1] = 1.0 - 2.0 * (x * x + z * z);
+  mat[1][2] = 2.0 * (y * z - w * x);
+  mat[2][0] = 2.0 * (x * z - w * y);
+  mat[2][1] = 2.0 * (y * z + w * x);
+  mat[2][2] = 1.0 - 2.0 * (x * x + y * y);
+}
+
+// write values to output object
+static bool writeValues (PyObject * out, const double * values, int count)
+{
+  // OpenGL types of bgl.Buffer
+  const int glFloat = 0x1406, glDouble = 0x140A;
+  if (BlenderBufferHolder::isSuitable(out))
+  {
+    Buffer * buffer = getPyType<Buffer>(out);
+    int size = 1;
+    for (int i = 0; i < buffer->ndimensions; ++i)
+      size *= buffer->dimensions[i];
+    if (size != count || (buffer->type != glFloat && buffer->type != glDouble))
+    {
+      PyErr_Format(PyExc_ValueError, "Output bgl.Buffer has to contain %d floats or doubles", count);
+      return false;
+    }
+    for (int i = 0; i < count; ++i)
+      if (buffer->type == glFloat)
+        buffer->buf.asfloat[i] = float(values[i]);
+      else
+        buffer->buf.asdouble[i] = values[i];
+    return true;
+  }
+
+  Py_buffer buffer;
+  if (PyObject_GetBuffer(out, &buffer, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0)
+    return false;
+  const char * format = buffer.format != NULL ? buffer.format : "B";
+  if (format[0] == '@')
+    ++format;
+  bool isFloat = std::strcmp(format, "f") == 0, isDouble = std::strcmp(format, "d") == 0;
+  if ((!isFloat && !isDouble) || buffer.len != count * buffer.itemsize)
+  {
+    PyBuffer_Release(&buffer);
+    PyErr_Format(PyExc_ValueError, "Output buffer has to contain %d float32 or float64 values", count);
+    return false;
+  }
+  for (int i = 0; i < count; ++i)
+    if (isFloat)
+      static_cast<float*>(buffer.buf)[i] = float(values[i]);
+    else
+      static_cast<double*>(buffer.buf)[i] = values[i];
+  PyBuffer_Release(&buffer);
+  return true;
+}
+
+// provide pose in requested form
+PyObject * returnPose (const ARdouble conv[3][4], PyObject * out, bool quaternion)
+{
+  double mat[4][4];
+  toBlenderMatrix(conv, mat);
+  if (quaternion)
+  {
+    // quaternion followed by translation
+    double values[7];
+    matrixToQuaternion(mat, values);
+    for (int i = 0; i < 3; ++i)
+      values[4 + i] = mat[i][3];
+    if (out == NULL || out == Py_None)
+      return Py_BuildValue("((dddd)(ddd))", values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+    if (!writeValues(out, values, 7))
+      return nullptr;
+  }
+  else
+  {
+    if (out == NULL || out == Py_None)
+      return buildMatrixTuple(mat);
+    if (!writeValues(out, &mat[0][0], 16))
+      return nullptr;
+  }
+  Py_INCREF(out);
+  return out;
+}
+
+}
\ No newline at end of file
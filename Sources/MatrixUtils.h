@@ -0,0 +1,109 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <Python.h>
+
+namespace ARTKBlender
+{
+
+/**
+    Functions converting transformation matrices between ARToolKit and Blender.
+    Blender's camera looks along negative Z axis with Y axis up, so the second
+    and the third row of ARToolKit matrix are negated.
+*/
+
+/**
+    Converts ARToolKit 3x4 transformation matrix to Blender 4x4 matrix.
+    \param conv ARToolKit matrix
+    \param mat  resulting Blender matrix
+*/
+void toBlenderMatrix (const ARdouble conv[3][4], double mat[4][4]);
+
+/**
+    Converts Blender 4x4 transformation matrix to ARToolKit 3x4 matrix.
+    \param mat  Blender matrix
+    \param conv resulting ARToolKit matrix
+*/
+void fromBlenderMatrix (const double mat[4][4], ARdouble conv[3][4]);
+
+/**
+    Builds tuple of 4 row tuples from matrix.
+    \param mat Blender matrix
+    \return new reference to tuple
+*/
+PyObject * buildMatrixTuple (const double mat[4][4]);
+
+/**
+    Parses matrix from tuple of 4 row tuples.
+    \param value python object with matrix
+    \param mat   resulting matrix
+    \return true, if matrix was parsed, otherwise python error is set
+*/
+bool parseMatrixTuple (PyObject * value, double mat[4][4]);
+
+/**
+    Creates contiguous float64 buffer for matrices with shape (count,4,4).
+    \param count number of matrices
+    \return new reference to memoryview of buffer, null if creation failed
+*/
+PyObject * createMatrixBuffer (Py_ssize_t count);
+
+/**
+    Gets contiguous float64 buffer with 16 values for every matrix.
+    \param obj      python object providing buffer
+    \param buffer   buffer to fill, it has to be released by PyBuffer_Release
+    \param count    required number of matrices
+    \param writable buffer has to be writable
+    \return true, if buffer is valid, otherwise python error is set
+*/
+bool getMatrixBuffer (PyObject * obj, Py_buffer * buffer, Py_ssize_t count, bool writable);
+
+/**
+    Converts rotation part of matrix to unit quaternion.
+    \param mat  transformation matrix
+    \param quat resulting quaternion (w, x, y, z)
+*/
+void matrixToQuaternion (const double mat[4][4], double quat[4]);
+
+/**
+    Sets rotation part of matrix from unit quaternion.
+    \param quat quaternion (w, x, y, z)
+    \param mat  transformation matrix
+*/
+void quaternionToMatrix (const double quat[4], double mat[4][4]);
+
+/**
+    Provides pose as 4x4 matrix or as quaternion (w, x, y, z) with translation.
+    Pose is either written to output object or returned as tuple of tuples.
+    Output may be bgl.Buffer of floats or doubles, or writable python buffer
+    with float32 or float64 items, with 16 values for matrix or 7 for quaternion
+    and translation.
+    \param conv       ARToolKit transformation matrix
+    \param out        output object, None or null to return tuple
+    \param quaternion provide quaternion and translation instead of matrix
+    \return new reference to output object or to tuple, null if writing failed
+*/
+PyObject * returnPose (const ARdouble conv[3][4], PyObject * out, bool quaternion);
+
+}
\ No newline at end of file
@@ -0,0 +1,323 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "ParamLTCache.h"
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace ARTKBlender
+{
+
+/// header of snapshot file, it's followed by i2o and o2i tables at data offset
+struct SnapshotHeader
+{
+  /// identification of file format
+  char magic[4];
+  /// version of file format
+  uint32_t version;
+  /// size of header, it differs with precision of ARdouble
+  uint32_t headerSize;
+  /// offset of lookup table
+  int32_t offset;
+  /// hash of camera parameters and offset
+  uint64_t hash;
+  /// size of table data in bytes
+  uint64_t dataSize;
+  /// camera parameters
+  ARParam param;
+  /// width of lookup table
+  int32_t xsize;
+  /// height of lookup table
+  int32_t ysize;
+  /// horizontal offset of lookup table
+  int32_t xOff;
+  /// vertical offset of lookup table
+  int32_t yOff;
+};
+
+/// identification of snapshot file format
+static const char snapshotMagic[4] = { 'A', 'R', 'L', 'T' };
+/// offset of table data in snapshot file, it's aligned to cache line
+static const size_t snapshotDataOffset = (sizeof(SnapshotHeader) + 63) / 64 * 64;
+
+// add bytes of value to FNV-1a hash
+template <class Value> static void hashValue (uint64_t & hash, const Value & value)
+{
+  const unsigned char * bytes = reinterpret_cast<const unsigned char*>(&value);
+  for (size_t i = 0; i < sizeof(Value); ++i)
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+}
+
+// get size of table data of lookup table
+static size_t getTableSize (int xsize, int ysize)
+{
+  // both directions of mapping store pair of coordinates per point
+  return 2 * size_t(xsize) * size_t(ysize) * 2 * sizeof(float);
+}
+
+// get process wide cache
+ParamLTCache & ParamLTCache::getInstance (void)
+{
+  // instance is never destroyed, handles may be released after static objects at exit
+  static ParamLTCache * instance = new ParamLTCache;
+  return *instance;
+}
+
+// get lookup table for camera parameters
+ARParamLT * ParamLTCache::acquire (const ARParam & param, int offset, const char * snapshot)
+{
+  uint64_t hash = getHash(param, offset);
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  // find cached table
+  Entry * cached = findEntry(hash, param, offset);
+  if (cached != nullptr)
+  {
+    ++hits;
+    ++cached->references;
+    return cached->paramLT;
+  }
+
+  // map table from snapshot or create new one
+  ++misses;
+  Entry entry = { hash, param, offset, nullptr, nullptr, 1, 0 };
+  if (snapshot == nullptr || !loadSnapshot(entry, snapshot))
+    entry.paramLT = arParamLTCreate(&entry.param, offset);
+  if (entry.paramLT == nullptr)
+    return nullptr;
+  entries.push_back(entry);
+  return entry.paramLT;
+}
+
+// release lookup table
+void ParamLTCache::release (ARParamLT * paramLT)
+{
+  if (paramLT == nullptr)
+    return;
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto entry = std::find_if(entries.begin(), entries.end(),
+    [paramLT] (const Entry & entry) { return entry.paramLT == paramLT; });
+  if (entry != entries.end() && entry->references > 0 && --entry->references == 0)
+  {
+    entry->lastUse = ++releases;
+    dropUnused();
+  }
+}
+
+// save lookup table to snapshot file
+bool ParamLTCache::saveSnapshot (const ARParam & param, int offset, const char * snapshot)
+{
+  // use cached table or compute temporary one, which isn't cached, so handles
+  // created later map the snapshot
+  uint64_t hash = getHash(param, offset);
+  ARParamLT * paramLT = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    Entry * cached = findEntry(hash, param, offset);
+    if (cached != nullptr)
+    {
+      ++cached->references;
+      paramLT = cached->paramLT;
+    }
+  }
+  bool isCached = paramLT != nullptr;
+  if (!isCached)
+  {
+    ARParam tempParam = param;
+    paramLT = arParamLTCreate(&tempParam, offset);
+    if (paramLT == nullptr)
+      return false;
+  }
+
+  // prepare header
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+  header.version = snapshotVersion;
+  header.headerSize = sizeof(SnapshotHeader);
+  header.offset = offset;
+  header.hash = hash;
+  header.param = param;
+  header.xsize = paramLT->paramLTf.xsize;
+  header.ysize = paramLT->paramLTf.ysize;
+  header.xOff = paramLT->paramLTf.xOff;
+  header.yOff = paramLT->paramLTf.yOff;
+  header.dataSize = getTableSize(header.xsize, header.ysize);
+
+  // write temporary file and replace snapshot by it, so mapped snapshot is never overwritten
+  std::string tempName = std::string(snapshot) + ".tmp";
+  bool result;
+  {
+    std::ofstream file(tempName, std::ios::binary | std::ios::trunc);
+    std::vector<char> padding(snapshotDataOffset - sizeof(header), 0);
+    std::streamsize half = std::streamsize(header.dataSize / 2);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(padding.data(), padding.size());
+    file.write(reinterpret_cast<const char*>(paramLT->paramLTf.i2o), half);
+    file.write(reinterpret_cast<const char*>(paramLT->paramLTf.o2i), half);
+    file.close();
+    result = !file.fail();
+  }
+  if (isCached)
+    release(paramLT);
+  else
+    arParamLTFree(&paramLT);
+  if (result)
+  {
+#ifdef _WIN32
+    // rename replaces existing file in one step, mapped snapshot shares deletion
+    result = MoveFileExA(tempName.c_str(), snapshot, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    result = std::rename(tempName.c_str(), snapshot) == 0;
+#endif
+  }
+  if (!result)
+    std::remove(tempName.c_str());
+  return result;
+}
+
+// get statistics of cache
+ParamLTCache::Stats ParamLTCache::getStats (void)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  Stats stats = { hits, misses, entries.size(), 0, 0, 0 };
+  for (const Entry & entry : entries)
+  {
+    if (entry.references == 0)
+      ++stats.unused;
+    if (entry.snapshot != nullptr)
+      ++stats.mapped;
+    stats.memory += getMemory(entry.paramLT);
+  }
+  return stats;
+}
+
+// find cached table
+ParamLTCache::Entry * ParamLTCache::findEntry (uint64_t hash, const ARParam & param, int offset)
+{
+  for (Entry & entry : entries)
+    if (entry.hash == hash && entry.offset == offset && isEqual(entry.param, param))
+      return &entry;
+  return nullptr;
+}
+
+// compute hash of camera parameters
+uint64_t ParamLTCache::getHash (const ARParam & param, int offset)
+{
+  uint64_t hash = 14695981039346656037ull;
+  hashValue(hash, param.xsize);
+  hashValue(hash, param.ysize);
+  hashValue(hash, param.mat);
+  hashValue(hash, param.dist_factor);
+  hashValue(hash, param.dist_function_version);
+  hashValue(hash, offset);
+  return hash;
+}
+
+// compare camera parameters
+bool ParamLTCache::isEqual (const ARParam & param1, const ARParam & param2)
+{
+  return param1.xsize == param2.xsize && param1.ysize == param2.ysize &&
+    param1.dist_function_version == param2.dist_function_version &&
+    std::memcmp(param1.mat, param2.mat, sizeof(param1.mat)) == 0 &&
+    std::memcmp(param1.dist_factor, param2.dist_factor, sizeof(param1.dist_factor)) == 0;
+}
+
+// compute memory used by lookup table
+size_t ParamLTCache::getMemory (const ARParamLT * paramLT)
+{
+  return sizeof(ARParamLT) + getTableSize(paramLT->paramLTf.xsize, paramLT->paramLTf.ysize);
+}
+
+// map lookup table from snapshot file
+bool ParamLTCache::loadSnapshot (Entry & entry, const char * fileName)
+{
+  MappedFile * file = new MappedFile(fileName);
+  const SnapshotHeader * header = static_cast<const SnapshotHeader*>(file->getData());
+  // check header and size of file
+  if (!file->isValid() || file->getSize() < snapshotDataOffset ||
+      std::memcmp(header->magic, snapshotMagic, sizeof(header->magic)) != 0 ||
+      header->version != snapshotVersion || header->headerSize != sizeof(SnapshotHeader) ||
+      header->hash != entry.hash || header->offset != entry.offset || !isEqual(header->param, entry.param) ||
+      header->xsize <= 0 || header->ysize <= 0 ||
+      header->dataSize != getTableSize(header->xsize, header->ysize) ||
+      file->getSize() != snapshotDataOffset + header->dataSize)
+  {
+    delete file;
+    return false;
+  }
+
+  // tables point to mapped data, lookup tables are only read
+  float * data = reinterpret_cast<float*>(const_cast<char*>(static_cast<const char*>(file->getData()) +
+    snapshotDataOffset));
+  entry.paramLT = new ARParamLT;
+  entry.paramLT->param = entry.param;
+  entry.paramLT->paramLTf.i2o = data;
+  entry.paramLT->paramLTf.o2i = data + size_t(header->xsize) * size_t(header->ysize) * 2;
+  entry.paramLT->paramLTf.xsize = header->xsize;
+  entry.paramLT->paramLTf.ysize = header->ysize;
+  entry.paramLT->paramLTf.xOff = header->xOff;
+  entry.paramLT->paramLTf.yOff = header->yOff;
+  entry.snapshot = file;
+  return true;
+}
+
+// release lookup table of entry
+void ParamLTCache::freeEntry (Entry & entry)
+{
+  if (entry.snapshot != nullptr)
+  {
+    delete entry.paramLT;
+    delete entry.snapshot;
+    entry.paramLT = nullptr;
+    entry.snapshot = nullptr;
+  }
+  else
+    arParamLTFree(&entry.paramLT);
+}
+
+// drop the oldest unused tables
+void ParamLTCache::dropUnused (void)
+{
+  size_t unused = std::count_if(entries.begin(), entries.end(),
+    [] (const Entry & entry) { return entry.references == 0; });
+  while (unused > unusedLimit)
+  {
+    auto oldest = entries.end();
+    for (auto entry = entries.begin(); entry != entries.end(); ++entry)
+      if (entry->references == 0 && (oldest == entries.end() || entry->lastUse < oldest->lastUse))
+        oldest = entry;
+    freeEntry(*oldest);
+    entries.erase(oldest);
+    --unused;
+  }
+}
+
+}
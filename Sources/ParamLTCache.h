@@ -0,0 +1,191 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+class MappedFile;
+
+/**
+    Process wide cache of lookup tables of camera parameters.
+
+    Lookup tables are immutable after creation, so handles with the same camera
+    parameters, image size and offset share one table. Tables are reference
+    counted, a few of unused ones are kept for handles created again later.
+
+    Tables can be saved to snapshot files, which are then mapped to memory
+    instead of computing tables again, so pages of snapshot are shared by all
+    processes using it.
+*/
+class ParamLTCache
+{
+public:
+  /// statistics of cache
+  struct Stats
+  {
+    /// number of requests served by existing table
+    unsigned long long hits;
+    /// number of requests creating new table
+    unsigned long long misses;
+    /// number of cached tables
+    size_t tables;
+    /// number of cached tables not used by any handle
+    size_t unused;
+    /// number of cached tables mapped from snapshot files
+    size_t mapped;
+    /// memory used by cached tables in bytes
+    size_t memory;
+  };
+
+  /// maximal number of unused tables kept in cache
+  static const size_t unusedLimit = 4;
+  /// version of format of snapshot files
+  static const uint32_t snapshotVersion = 1;
+
+  /**
+      Provides process wide instance of cache.
+      \return cache
+  */
+  static ParamLTCache & getInstance (void);
+
+  /**
+      Provides lookup table for camera parameters, if it isn't cached yet, it's
+      mapped from snapshot file matching parameters or created.
+      \param param    camera parameters including image size
+      \param offset   offset of lookup table
+      \param snapshot name of snapshot file, can be null
+      \return lookup table, it has to be released by release, null if creation failed
+  */
+  ARParamLT * acquire (const ARParam & param, int offset, const char * snapshot = nullptr);
+
+  /**
+      Releases lookup table provided by acquire.
+      \param paramLT lookup table, null is ignored
+  */
+  void release (ARParamLT * paramLT);
+
+  /**
+      Saves lookup table for camera parameters to snapshot file.
+      \param param    camera parameters including image size
+      \param offset   offset of lookup table
+      \param snapshot name of snapshot file
+      \return true, if successful
+  */
+  bool saveSnapshot (const ARParam & param, int offset, const char * snapshot);
+
+  /**
+      Provides statistics of cache.
+      \return statistics
+  */
+  Stats getStats (void);
+
+protected:
+  /// cached lookup table
+  struct Entry
+  {
+    /// hash of camera parameters and offset
+    uint64_t hash;
+    /// camera parameters
+    ARParam param;
+    /// offset of lookup table
+    int offset;
+    /// lookup table
+    ARParamLT * paramLT;
+    /// mapped snapshot holding data of lookup table, null for computed table
+    MappedFile * snapshot;
+    /// number of handles using table
+    size_t references;
+    /// sequence number of the last release, the oldest unused table is dropped first
+    unsigned long long lastUse;
+  };
+
+  /// cached tables
+  std::vector<Entry> entries;
+  /// mutex guarding cache
+  std::mutex cacheMutex;
+  /// number of cache hits
+  unsigned long long hits = 0;
+  /// number of cache misses
+  unsigned long long misses = 0;
+  /// counter of releases
+  unsigned long long releases = 0;
+
+  /**
+      Finds cached table, cache has to be locked.
+      \param hash   hash of camera parameters and offset
+      \param param  camera parameters
+      \param offset offset of lookup table
+      \return cache entry, null if table isn't cached
+  */
+  Entry * findEntry (uint64_t hash, const ARParam & param, int offset);
+
+  /**
+      Computes hash of camera parameters and offset.
+      \param param  camera parameters
+      \param offset offset of lookup table
+      \return hash value
+  */
+  static uint64_t getHash (const ARParam & param, int offset);
+
+  /**
+      Compares camera parameters.
+      \param param1 first camera parameters
+      \param param2 second camera parameters
+      \return true, if parameters are equal
+  */
+  static bool isEqual (const ARParam & param1, const ARParam & param2);
+
+  /**
+      Computes memory used by lookup table.
+      \param paramLT lookup table
+      \return size in bytes
+  */
+  static size_t getMemory (const ARParamLT * paramLT);
+
+  /**
+      Maps lookup table from snapshot file, if it matches camera parameters.
+      \param entry    entry with camera parameters and offset, table and snapshot are set
+      \param fileName name of snapshot file
+      \return true, if snapshot is valid
+  */
+  static bool loadSnapshot (Entry & entry, const char * fileName);
+
+  /**
+      Releases lookup table of entry.
+      \param entry cache entry
+  */
+  static void freeEntry (Entry & entry);
+
+  /**
+      Drops the oldest unused tables exceeding limit of unused tables.
+  */
+  void dropUnused (void);
+};
+
+}
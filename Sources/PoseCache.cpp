@@ -0,0 +1,179 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "PoseCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ARTKBlender
+{
+
+// compare pose with pattern ID
+static bool lessID (const PoseEntry & pose, int id)
+{
+  return pose.id < id;
+}
+
+// get angular velocity vector of rotation from one matrix to other
+static void getAngularVelocity (const ARdouble from[3][4], const ARdouble to[3][4], double elapsed, double velocity[3])
+{
+  // difference rotation to * from^T
+  double diff[3][3];
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      diff[i][j] = to[i][0] * from[j][0] + to[i][1] * from[j][1] + to[i][2] * from[j][2];
+  // axis scaled by sine of angle, rescaled to angle
+  double axis[3] = { 0.5 * (diff[2][1] - diff[1][2]), 0.5 * (diff[0][2] - diff[2][0]), 0.5 * (diff[1][0] - diff[0][1]) };
+  double sinAngle = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+  double angle = std::atan2(sinAngle, 0.5 * (diff[0][0] + diff[1][1] + diff[2][2] - 1.0));
+  double scale = (sinAngle > 1e-9 ? angle / sinAngle : 1.0) / elapsed;
+  for (int i = 0; i < 3; ++i)
+    velocity[i] = axis[i] * scale;
+}
+
+// rotate matrix by rotation vector
+static void rotateMatrix (const double rotation[3], ARdouble conv[3][4])
+{
+  // rotation matrix by Rodrigues formula
+  double angle = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2]);
+  if (angle < 1e-12)
+    return;
+  double x = rotation[0] / angle, y = rotation[1] / angle, z = rotation[2] / angle;
+  double c = std::cos(angle), s = std::sin(angle), t = 1.0 - c;
+  double rot[3][3] = { { t * x * x + c, t * x * y - s * z, t * x * z + s * y },
+    { t * x * y + s * z, t * y * y + c, t * y * z - s * x },
+    { t * x * z - s * y, t * y * z + s * x, t * z * z + c } };
+  // apply rotation to rotation part of matrix
+  ARdouble result[3][3];
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      result[i][j] = rot[i][0] * conv[0][j] + rot[i][1] * conv[1][j] + rot[i][2] * conv[2][j];
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      conv[i][j] = result[i][j];
+}
+
+
+// constructor
+PoseCache::PoseCache (void)
+  : expiry(0.5), errorThreshold(10.0), predictionLimit(0.1), continuousSolves(0), freshSolves(0)
+{}
+
+// solve pose of marker
+double PoseCache::solve (AR3DHandle * handle, ARMarkerInfo & marker, double width, double time, ARdouble conv[3][4])
+{
+  // unidentified markers can't be matched with previous poses
+  if (marker.id < 0)
+  {
+    ++freshSolves;
+    return arGetTransMatSquare(handle, &marker, width, conv);
+  }
+
+  // continue from recent pose, if its result is good enough
+  double error = -1.0;
+  const PoseEntry * prior = find(marker.id, time);
+  if (prior != nullptr)
+  {
+    ARdouble initConv[3][4];
+    std::memcpy(initConv, prior->conv, sizeof(initConv));
+    error = arGetTransMatSquareCont(handle, &marker, initConv, width, conv);
+    ++continuousSolves;
+  }
+  if (error < 0.0 || error > errorThreshold)
+  {
+    error = arGetTransMatSquare(handle, &marker, width, conv);
+    ++freshSolves;
+  }
+
+  store(marker.id, time, error, conv);
+  return error;
+}
+
+// find recent pose
+const PoseEntry * PoseCache::find (int id, double time) const
+{
+  auto pose = std::lower_bound(poses.begin(), poses.end(), id, lessID);
+  if (pose == poses.end() || pose->id != id || time - pose->time > expiry)
+    return nullptr;
+  return &*pose;
+}
+
+// extrapolate pose
+bool PoseCache::predict (int id, double time, ARdouble conv[3][4]) const
+{
+  const PoseEntry * pose = find(id, time);
+  if (pose == nullptr)
+    return false;
+  // extrapolate only forward and not too far
+  double elapsed = std::min(std::max(time - pose->time, 0.0), predictionLimit);
+  std::memcpy(conv, pose->conv, sizeof(pose->conv));
+  for (int i = 0; i < 3; ++i)
+    conv[i][3] += pose->velocity[i] * elapsed;
+  double rotation[3] = { pose->angularVelocity[0] * elapsed, pose->angularVelocity[1] * elapsed,
+    pose->angularVelocity[2] * elapsed };
+  rotateMatrix(rotation, conv);
+  return true;
+}
+
+// forget poses
+void PoseCache::clear (void)
+{
+  poses.clear();
+}
+
+// store pose
+void PoseCache::store (int id, double time, double error, const ARdouble conv[3][4])
+{
+  auto pose = std::lower_bound(poses.begin(), poses.end(), id, lessID);
+  bool found = pose != poses.end() && pose->id == id;
+  // poses with high error aren't kept
+  if (error < 0.0 || error > errorThreshold)
+  {
+    if (found)
+      poses.erase(pose);
+    return;
+  }
+  // estimate velocity from recent previous pose
+  double elapsed = found ? time - pose->time : 0.0;
+  if (elapsed > 0.0 && elapsed <= expiry)
+  {
+    for (int i = 0; i < 3; ++i)
+      pose->velocity[i] = (conv[i][3] - pose->conv[i][3]) / elapsed;
+    getAngularVelocity(pose->conv, conv, elapsed, pose->angularVelocity);
+  }
+  else if (elapsed != 0.0 || !found)
+  {
+    if (!found)
+    {
+      pose = poses.insert(pose, PoseEntry());
+      pose->id = id;
+    }
+    std::fill(pose->velocity, pose->velocity + 3, 0.0);
+    std::fill(pose->angularVelocity, pose->angularVelocity + 3, 0.0);
+  }
+  pose->time = time;
+  pose->error = error;
+  std::memcpy(pose->conv, conv, sizeof(pose->conv));
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/// pose of marker from previous solve
+struct PoseEntry
+{
+  /// pattern ID of marker
+  int id;
+  /// time of solve in seconds
+  double time;
+  /// fit error of solve
+  double error;
+  /// ARToolKit transformation matrix
+  ARdouble conv[3][4];
+  /// velocity of translation per second
+  double velocity[3];
+  /// angular velocity in radians per second as rotation axis vector
+  double angularVelocity[3];
+};
+
+/**
+    Cache of the last poses of markers keyed by their pattern ID.
+
+    Pose is used as prior for continuous solve, if it isn't older than expiry
+    time. Poses with error above threshold aren't kept.
+*/
+class PoseCache
+{
+public:
+  /**
+      Constructor sets default parameters.
+  */
+  PoseCache (void);
+
+  /// maximal age of pose in seconds to be used as prior
+  double expiry;
+  /// maximal fit error of pose to be kept or accepted from continuous solve
+  double errorThreshold;
+  /// maximal time in seconds, for which pose is extrapolated
+  double predictionLimit;
+  /// number of continuous solves
+  unsigned long long continuousSolves;
+  /// number of fresh solves
+  unsigned long long freshSolves;
+
+  /**
+      Solves pose of marker, continuous solver is used, if recent prior exists.
+      \param handle 3D handle used for solving
+      \param marker detected marker
+      \param width  width of marker
+      \param time   time of marker detection in seconds
+      \param conv   resulting ARToolKit transformation matrix
+      \return fit error of pose
+  */
+  double solve (AR3DHandle * handle, ARMarkerInfo & marker, double width, double time, ARdouble conv[3][4]);
+
+  /**
+      Finds pose of marker, which isn't expired.
+      \param id   pattern ID of marker
+      \param time current time in seconds
+      \return pointer to pose, null if it isn't available
+  */
+  const PoseEntry * find (int id, double time) const;
+
+  /**
+      Extrapolates pose of marker to given time using its velocity.
+      \param id   pattern ID of marker
+      \param time time of prediction in seconds
+      \param conv resulting ARToolKit transformation matrix
+      \return true, if recent pose of marker is available
+  */
+  bool predict (int id, double time, ARdouble conv[3][4]) const;
+
+  /**
+      Forgets all poses.
+  */
+  void clear (void);
+
+protected:
+  /// poses sorted by pattern ID
+  std::vector<PoseEntry> poses;
+
+  /**
+      Stores pose of marker or removes it, if its error is too high. Velocity
+      is estimated from difference to previous pose.
+      \param id    pattern ID of marker
+      \param time  time of solve in seconds
+      \param error fit error of pose
+      \param conv  ARToolKit transformation matrix
+  */
+  void store (int id, double time, double error, const ARdouble conv[3][4]);
+};
+
+}
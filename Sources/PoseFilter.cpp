@@ -0,0 +1,132 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "PoseFilter.h"
+
+#include "MatrixUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ARTKBlender
+{
+
+// compare state with pattern ID
+static bool lessID (const PoseFilterState & state, int id)
+{
+  return state.id < id;
+}
+
+// smoothing factor of low pass filter
+static double getAlpha (double cutoff, double elapsed)
+{
+  const double pi = 3.14159265358979323846;
+  double tau = 1.0 / (2.0 * pi * cutoff);
+  return 1.0 / (1.0 + tau / elapsed);
+}
+
+
+// constructor
+PoseFilter::PoseFilter (void) : minCutoff(1.0), beta(0.0), derivativeCutoff(1.0), expiry(0.5)
+{}
+
+// filter pose
+void PoseFilter::filter (int id, double time, double mat[4][4])
+{
+  // get rotation and translation of pose
+  double rotation[4];
+  matrixToQuaternion(mat, rotation);
+  double position[3] = { mat[0][3], mat[1][3], mat[2][3] };
+
+  // find state of marker
+  auto state = std::lower_bound(states.begin(), states.end(), id, lessID);
+  if (state == states.end() || state->id != id)
+  {
+    state = states.insert(state, PoseFilterState());
+    state->id = id;
+    state->time = time - 2.0 * expiry;
+  }
+
+  double elapsed = time - state->time;
+  if (elapsed > expiry)
+  {
+    // restart filter with new pose
+    std::copy(position, position + 3, state->position);
+    std::fill(state->positionSpeed, state->positionSpeed + 3, 0.0);
+    std::copy(rotation, rotation + 4, state->rotation);
+    std::fill(state->rotationSpeed, state->rotationSpeed + 4, 0.0);
+    state->time = time;
+    return;
+  }
+  if (elapsed > 0.0)
+  {
+    // quaternions q and -q are the same rotation, use the one closer to previous
+    double dot = 0.0;
+    for (int i = 0; i < 4; ++i)
+      dot += rotation[i] * state->rotation[i];
+    if (dot < 0.0)
+      for (int i = 0; i < 4; ++i)
+        rotation[i] = -rotation[i];
+
+    // filter values and normalize rotation
+    filterValue(position, state->position, state->positionSpeed, 3, elapsed);
+    filterValue(rotation, state->rotation, state->rotationSpeed, 4, elapsed);
+    double norm = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2] +
+      rotation[3] * rotation[3]);
+    for (int i = 0; i < 4; ++i)
+      rotation[i] /= norm;
+
+    std::copy(position, position + 3, state->position);
+    std::copy(rotation, rotation + 4, state->rotation);
+    state->time = time;
+  }
+
+  // replace pose by filtered one
+  quaternionToMatrix(state->rotation, mat);
+  for (int i = 0; i < 3; ++i)
+    mat[i][3] = state->position[i];
+}
+
+// forget states
+void PoseFilter::reset (void)
+{
+  states.clear();
+}
+
+// filter vector value
+void PoseFilter::filterValue (double * value, const double * prev, double * speed, int size, double elapsed) const
+{
+  // filter speed and get its magnitude
+  double speedAlpha = getAlpha(derivativeCutoff, elapsed);
+  double speedNorm = 0.0;
+  for (int i = 0; i < size; ++i)
+  {
+    speed[i] += speedAlpha * ((value[i] - prev[i]) / elapsed - speed[i]);
+    speedNorm += speed[i] * speed[i];
+  }
+
+  // filter value with cutoff adapted to speed
+  double alpha = getAlpha(minCutoff + beta * std::sqrt(speedNorm), elapsed);
+  for (int i = 0; i < size; ++i)
+    value[i] = prev[i] + alpha * (value[i] - prev[i]);
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/// filtered pose of one marker
+struct PoseFilterState
+{
+  /// pattern ID of marker
+  int id;
+  /// time of the last update in seconds
+  double time;
+  /// filtered translation
+  double position[3];
+  /// filtered speed of translation
+  double positionSpeed[3];
+  /// filtered rotation quaternion (w, x, y, z)
+  double rotation[4];
+  /// filtered speed of rotation quaternion
+  double rotationSpeed[4];
+};
+
+/**
+    One Euro filter of marker poses keyed by pattern ID.
+
+    Translation and rotation quaternion are filtered by low pass filters,
+    whose cutoff frequency rises with speed, so slow motion is smoothed and
+    fast motion isn't delayed much. States are stored in flat table sorted by
+    pattern ID.
+*/
+class PoseFilter
+{
+public:
+  /**
+      Constructor sets default parameters.
+  */
+  PoseFilter (void);
+
+  /// minimal cutoff frequency in Hz
+  double minCutoff;
+  /// increase of cutoff frequency per unit of speed
+  double beta;
+  /// cutoff frequency of speed in Hz
+  double derivativeCutoff;
+  /// maximal time in seconds between updates of marker, older state is restarted
+  double expiry;
+
+  /**
+      Filters pose of marker.
+      \param id   pattern ID of marker
+      \param time time of pose in seconds
+      \param mat  transformation matrix, it's replaced by filtered one
+  */
+  void filter (int id, double time, double mat[4][4]);
+
+  /**
+      Forgets states of all markers.
+  */
+  void reset (void);
+
+protected:
+  /// states of markers sorted by pattern ID
+  std::vector<PoseFilterState> states;
+
+  /**
+      Filters vector value.
+      \param value   new value, it's replaced by filtered one
+      \param prev    previous filtered value
+      \param speed   previous filtered speed, it's updated
+      \param size    number of components
+      \param elapsed time since previous value
+  */
+  void filterValue (double * value, const double * prev, double * speed, int size, double elapsed) const;
+};
+
+}
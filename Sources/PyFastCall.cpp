@@ -0,0 +1,144 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "PyFastCall.h"
+
+#include <climits>
+
+namespace ARTKBlender
+{
+
+// set value of keyword argument
+static bool setKeywordArg (const char * funcName, PyObject * name, PyObject * value, const char * const * names,
+  size_t count, PyObject ** values, bool * passed)
+{
+  size_t param = 0;
+  while (param < count && PyUnicode_CompareWithASCIIString(name, names[param]) != 0)
+    ++param;
+  if (param == count)
+  {
+    PyErr_Format(PyExc_TypeError, "'%U' is an invalid keyword argument for %s()", name, funcName);
+    return false;
+  }
+  if (passed[param])
+  {
+    PyErr_Format(PyExc_TypeError, "argument for %s() given by name ('%s') and position (%d)", funcName,
+      names[param], int(param + 1));
+    return false;
+  }
+  values[param] = value;
+  passed[param] = true;
+  return true;
+}
+
+// unpack arguments by names of parameters
+bool unpackFastArgs (const char * funcName, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames,
+  const char * const * names, size_t count, size_t required, PyObject ** values, bool * passed)
+{
+  if (size_t(nargs) > count)
+  {
+    PyErr_Format(PyExc_TypeError, "%s() takes at most %d positional arguments (%d given)", funcName,
+      int(count), int(nargs));
+    return false;
+  }
+  // positional arguments
+  for (size_t param = 0; param < count; ++param)
+    passed[param] = Py_ssize_t(param) < nargs;
+  for (Py_ssize_t arg = 0; arg < nargs; ++arg)
+    values[arg] = args[arg];
+  // keyword arguments follow positional ones, adapter of older versions passes them in dictionary
+#ifdef ARTK_USE_FASTCALL
+  Py_ssize_t kwcount = kwnames != nullptr ? PyTuple_GET_SIZE(kwnames) : 0;
+  for (Py_ssize_t kwarg = 0; kwarg < kwcount; ++kwarg)
+    if (!setKeywordArg(funcName, PyTuple_GET_ITEM(kwnames, kwarg), args[nargs + kwarg], names, count, values, passed))
+      return false;
+#else
+  PyObject * name;
+  PyObject * value;
+  Py_ssize_t pos = 0;
+  while (kwnames != nullptr && PyDict_Next(kwnames, &pos, &name, &value))
+    if (!setKeywordArg(funcName, name, value, names, count, values, passed))
+      return false;
+#endif
+  // check required parameters
+  for (size_t param = 0; param < required; ++param)
+    if (!passed[param])
+    {
+      PyErr_Format(PyExc_TypeError, "required argument '%s' (pos %d) not found in %s()", names[param],
+        int(param + 1), funcName);
+      return false;
+    }
+  return true;
+}
+
+// check type of argument
+bool checkArgType (const char * funcName, PyObject * value, PyTypeObject & pyType)
+{
+  if (PyObject_TypeCheck(value, &pyType))
+    return true;
+  PyErr_Format(PyExc_TypeError, "%s() argument must be %s, not %s", funcName, pyType.tp_name,
+    Py_TYPE(value)->tp_name);
+  return false;
+}
+
+// convert argument to double
+bool getArgDouble (PyObject * value, double & result)
+{
+  result = PyFloat_AsDouble(value);
+  return result != -1.0 || !PyErr_Occurred();
+}
+
+// convert argument to int
+bool getArgInt (PyObject * value, int & result)
+{
+  long val = PyLong_AsLong(value);
+  if (val == -1 && PyErr_Occurred())
+    return false;
+  if (val < INT_MIN || val > INT_MAX)
+  {
+    PyErr_SetString(PyExc_OverflowError, "Python int too large to convert to C int");
+    return false;
+  }
+  result = int(val);
+  return true;
+}
+
+// convert argument to bool
+bool getArgBool (PyObject * value, bool & result)
+{
+  int val = PyObject_IsTrue(value);
+  result = val > 0;
+  return val >= 0;
+}
+
+// convert argument to string
+bool getArgString (const char * funcName, PyObject * value, const char *& result)
+{
+  if (!PyUnicode_Check(value))
+  {
+    PyErr_Format(PyExc_TypeError, "%s() argument must be str, not %s", funcName, Py_TYPE(value)->tp_name);
+    return false;
+  }
+  result = PyUnicode_AsUTF8(value);
+  return result != nullptr;
+}
+
+}
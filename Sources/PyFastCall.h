@@ -0,0 +1,158 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <Python.h>
+
+#include <cstddef>
+
+namespace ARTKBlender
+{
+
+/**
+    Support of methods with fast calling convention. Methods are implemented
+    with signature of METH_FASTCALL | METH_KEYWORDS, i.e. they receive array of
+    positional arguments followed by values of keyword arguments named in tuple.
+    Python versions older than 3.7 don't support the convention, methods are
+    then bound with METH_VARARGS | METH_KEYWORDS through adapter passing items
+    of argument tuple and dictionary of keyword arguments in place of names,
+    so nothing is copied. Methods pass keywords only to unpackFastArgs.
+*/
+
+#if PY_VERSION_HEX >= 0x03070000
+#define ARTK_USE_FASTCALL
+#endif
+
+/// signature of method with fast calling convention
+template <class PyType> using PyFastMethod = PyObject * (*)(PyType * self, PyObject * const * args,
+  Py_ssize_t nargs, PyObject * kwnames);
+
+/**
+    Adapter of method with fast calling convention to METH_VARARGS | METH_KEYWORDS.
+    Method receives items of tuple and dictionary of keyword arguments, which
+    is unpacked by unpackFastArgs, empty dictionary is passed as null.
+    \param self python object
+    \param args tuple of positional arguments
+    \param kwds dictionary of keyword arguments, can be null
+    \return result of method
+*/
+template <class PyType, PyFastMethod<PyType> method>
+PyObject * fastMethodAdapter (PyObject * self, PyObject * args, PyObject * kwds)
+{
+  return method(reinterpret_cast<PyType*>(self), &PyTuple_GET_ITEM(args, 0), PyTuple_GET_SIZE(args),
+    kwds != nullptr && PyDict_Size(kwds) != 0 ? kwds : nullptr);
+}
+
+/// function pointer and flags of method with fast calling convention in PyMethodDef
+#ifdef ARTK_USE_FASTCALL
+#define PY_FASTCALL_METHOD(PyType, method) \
+  (PyCFunction)(void(*)(void))(PyFastMethod<PyType>)method, METH_FASTCALL | METH_KEYWORDS
+#else
+#define PY_FASTCALL_METHOD(PyType, method) \
+  (PyCFunction)(PyCFunctionWithKeywords)fastMethodAdapter<PyType, method>, METH_VARARGS | METH_KEYWORDS
+#endif
+
+/**
+    Unpacks arguments of method with fast calling convention by names of parameters.
+    \param funcName name of method used in error messages
+    \param args     array of positional arguments followed by values of keyword arguments
+    \param nargs    count of positional arguments
+    \param kwnames  tuple of names of keyword arguments or dictionary of them from adapter, can be null
+    \param names    names of parameters
+    \param count    count of parameters
+    \param required count of required parameters
+    \param values   values of parameters, values of optional parameters not passed stay unchanged
+    \param passed   flags of passed parameters, array of count items
+    \return true, if successful, otherwise python error is set
+*/
+bool unpackFastArgs (const char * funcName, PyObject * const * args, Py_ssize_t nargs, PyObject * kwnames,
+  const char * const * names, size_t count, size_t required, PyObject ** values, bool * passed);
+
+/**
+    Unpacks arguments of method with fast calling convention by names of parameters.
+    \param funcName name of method used in error messages
+    \param args     array of positional arguments followed by values of keyword arguments
+    \param nargs    count of positional arguments
+    \param kwnames  tuple of names of keyword arguments or dictionary of them from adapter, can be null
+    \param names    names of parameters
+    \param required count of required parameters
+    \param values   values of parameters, values of optional parameters not passed stay unchanged
+    \return true, if successful, otherwise python error is set
+*/
+template <size_t count> bool unpackFastArgs (const char * funcName, PyObject * const * args, Py_ssize_t nargs,
+  PyObject * kwnames, const char * const (&names)[count], size_t required, PyObject * (&values)[count])
+{
+  // positional arguments only are the common case
+  if (kwnames == nullptr && size_t(nargs) >= required && size_t(nargs) <= count)
+  {
+    for (Py_ssize_t arg = 0; arg < nargs; ++arg)
+      values[arg] = args[arg];
+    return true;
+  }
+  // flags of passed parameters are on stack, so keyword calls don't allocate
+  bool passed[count];
+  return unpackFastArgs(funcName, args, nargs, kwnames, names, count, required, values, passed);
+}
+
+/**
+    Checks type of argument.
+    \param funcName name of method used in error messages
+    \param value    value of argument
+    \param pyType   required type
+    \return true, if value is of required type, otherwise python error is set
+*/
+bool checkArgType (const char * funcName, PyObject * value, PyTypeObject & pyType);
+
+/**
+    Converts argument to double.
+    \param value  value of argument
+    \param result converted value
+    \return true, if successful, otherwise python error is set
+*/
+bool getArgDouble (PyObject * value, double & result);
+
+/**
+    Converts argument to int.
+    \param value  value of argument
+    \param result converted value
+    \return true, if successful, otherwise python error is set
+*/
+bool getArgInt (PyObject * value, int & result);
+
+/**
+    Converts argument to bool by its truth value.
+    \param value  value of argument
+    \param result converted value
+    \return true, if successful, otherwise python error is set
+*/
+bool getArgBool (PyObject * value, bool & result);
+
+/**
+    Converts argument to UTF-8 string, string is owned by argument.
+    \param funcName name of method used in error messages
+    \param value    value of argument
+    \param result   converted value
+    \return true, if successful, otherwise python error is set
+*/
+bool getArgString (const char * funcName, PyObject * value, const char *& result);
+
+}
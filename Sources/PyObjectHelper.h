@@ -22,6 +22,7 @@ along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <Python.h>
+#include <mutex>
 
 namespace ARTKBlender
 {
@@ -167,4 +168,75 @@ protected:
   PyObject * pyObject;
 };
 
+
+/**
+    Class to release python interpreter lock (GIL) for the time of its existence.
+    Native locks may be waited for only while the interpreter lock is released,
+    interpreter lock may be then taken back while holding them.
+*/
+class PyAllowThreads
+{
+public:
+  /**
+      Constructor releases interpreter lock.
+  */
+  PyAllowThreads (void) : threadState(PyEval_SaveThread())
+  {}
+
+  /**
+      Destructor takes interpreter lock back, if it wasn't restored yet.
+  */
+  ~PyAllowThreads (void)
+  {
+    restore();
+  }
+
+  /**
+      Takes interpreter lock back before end of object's existence.
+  */
+  void restore (void)
+  {
+    if (threadState != nullptr)
+    {
+      PyEval_RestoreThread(threadState);
+      threadState = nullptr;
+    }
+  }
+
+protected:
+  /// saved state of current python thread
+  PyThreadState * threadState;
+
+  PyAllowThreads (const PyAllowThreads &) = delete;
+  PyAllowThreads & operator= (const PyAllowThreads &) = delete;
+};
+
+
+/**
+    Lock of native mutex, it's waited for with released interpreter lock, so it
+    can't deadlock with thread holding the mutex and waiting for interpreter lock.
+    Uncontended mutex is taken without release of interpreter lock.
+    Interpreter lock is held again, when constructor returns.
+*/
+class PyMutexLock
+{
+public:
+  /**
+      Constructor locks mutex.
+      \param mutex mutex to lock
+  */
+  PyMutexLock (std::mutex & mutex) : mutexLock(mutex, std::try_to_lock)
+  {
+    if (!mutexLock.owns_lock())
+    {
+      PyAllowThreads allowThreads;
+      mutexLock.lock();
+    }
+  }
+
+protected:
+  /// lock of mutex
+  std::unique_lock<std::mutex> mutexLock;
+};
+
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "PyramidDetector.h"
+
+#include "ImageUtils.h"
+
+#include <algorithm>
+
+namespace ARTKBlender
+{
+
+// constructor
+PyramidDetector::PyramidDetector (void) : levels(0)
+{}
+
+// detect markers in image
+bool PyramidDetector::detect (ARHandle * handle, ARUint8 * image)
+{
+  // prepare luminance plane, luminance formats are used directly
+  const ARUint8 * luma = image;
+  if (!isLumaFormat(handle->arPixelFormat))
+  {
+    pyramid[0].resize(size_t(handle->xsize) * handle->ysize);
+    convertToLuma(image, pyramid[0].data(), handle->xsize, handle->ysize, handle->arPixelFormat);
+    luma = pyramid[0].data();
+  }
+  // downsample luminance
+  const ARUint8 * level = luma;
+  int xsize = handle->xsize, ysize = handle->ysize;
+  for (int i = 1; i <= levels; ++i)
+  {
+    pyramid[i].resize(size_t(xsize / 2) * (ysize / 2));
+    halveLuma(level, xsize, ysize, pyramid[i].data());
+    level = pyramid[i].data();
+    xsize /= 2;
+    ysize /= 2;
+  }
+
+  // automatic threshold is computed from downsampled image, its histogram approximates the full one
+  if (handle->arLabelingThreshMode == AR_LABELING_THRESH_MODE_AUTO_MEDIAN
+    || handle->arLabelingThreshMode == AR_LABELING_THRESH_MODE_AUTO_OTSU)
+    handle->arLabelingThresh = computeAutoThreshold(level, xsize, ysize, AR_PIXEL_FORMAT_MONO,
+      handle->arLabelingThreshMode);
+
+  // label downsampled image and find candidate squares
+  const int scale = 1 << levels;
+  if (arLabeling(const_cast<ARUint8*>(level), xsize, ysize, AR_PIXEL_FORMAT_MONO, handle->arDebug, handle->arLabelingMode,
+      handle->arLabelingThresh, AR_IMAGE_PROC_FRAME_IMAGE, &handle->labelInfo, NULL) < 0)
+    return false;
+  if (arDetectMarker2(xsize, ysize, &handle->labelInfo, AR_IMAGE_PROC_FRAME_IMAGE, AR_AREA_MAX / (scale * scale),
+      std::max(AR_AREA_MIN / (scale * scale), 16), AR_SQUARE_FIT_THRESH, handle->markerInfo2, &handle->marker2_num) < 0)
+    return false;
+
+  // refine squares in full resolution
+  for (int i = 0; i < handle->marker2_num; ++i)
+    refineSquare(handle, handle->markerInfo2[i], luma);
+
+  // match patterns in full resolution image, refined squares are in frame coordinates in field mode too
+  return arGetMarkerInfo(image, handle->xsize, handle->ysize, handle->arPixelFormat, handle->markerInfo2,
+    handle->marker2_num, handle->pattHandle, AR_IMAGE_PROC_FRAME_IMAGE, handle->arPatternDetectionMode,
+    &handle->arParamLT->paramLTf, handle->pattRatio, handle->markerInfo, &handle->marker_num,
+    handle->matrixCodeType) >= 0;
+}
+
+// refine contour of square in full resolution
+void PyramidDetector::refineSquare (ARHandle * handle, ARMarkerInfo2 & square, const ARUint8 * luma) const
+{
+  const int scale = 1 << levels;
+  const int xsize = handle->xsize, ysize = handle->ysize;
+  const bool blackRegion = handle->arLabelingMode == AR_LABELING_BLACK_REGION;
+  const int thresh = handle->arLabelingThresh;
+  // pixel belongs to labeled region
+  auto inside = [=](int x, int y)
+  {
+    ARUint8 value = luma[size_t(y) * xsize + x];
+    return blackRegion ? value <= thresh : value > thresh;
+  };
+
+  square.area *= scale * scale;
+  square.pos[0] = square.pos[0] * scale + (scale - 1) * 0.5;
+  square.pos[1] = square.pos[1] * scale + (scale - 1) * 0.5;
+  for (int i = 0; i < square.coord_num; ++i)
+  {
+    // full resolution patch covered by coarse contour point
+    const int left = square.x_coord[i] * scale, top = square.y_coord[i] * scale;
+    int bestX = left + scale / 2, bestY = top + scale / 2;
+    int bestDist = scale * scale;
+    // find boundary pixel of labeled region nearest to center of patch
+    for (int y = std::max(top, 1); y < std::min(top + scale, ysize - 1); ++y)
+      for (int x = std::max(left, 1); x < std::min(left + scale, xsize - 1); ++x)
+      {
+        if (!inside(x, y) || (inside(x - 1, y) && inside(x + 1, y) && inside(x, y - 1) && inside(x, y + 1)))
+          continue;
+        int dist = (2 * (x - left) + 1 - scale) * (2 * (x - left) + 1 - scale) +
+          (2 * (y - top) + 1 - scale) * (2 * (y - top) + 1 - scale);
+        if (dist < bestDist * 4)
+        {
+          bestDist = dist / 4;
+          bestX = x;
+          bestY = y;
+        }
+      }
+    square.x_coord[i] = bestX;
+    square.y_coord[i] = bestY;
+  }
+}
+
+}
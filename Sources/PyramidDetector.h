@@ -0,0 +1,73 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/**
+    Coarse-to-fine detection of markers.
+
+    Image is converted to luminance and downsampled, candidate squares are
+    labeled in downsampled image. Their contours are then refined in small
+    full resolution patches and patterns are matched in full resolution image
+    using lookup table of the handle.
+*/
+class PyramidDetector
+{
+public:
+  /// maximal number of pyramid levels
+  static const int maxLevels = 2;
+
+  /**
+      Constructor sets default parameters, pyramid detection is disabled.
+  */
+  PyramidDetector (void);
+
+  /// number of pyramid levels, every level halves image size, 0 disables pyramid detection
+  int levels;
+
+  /**
+      Detects markers in image.
+      \param handle handle used for detection
+      \param image  image data
+      \return true, if detection was successful
+  */
+  bool detect (ARHandle * handle, ARUint8 * image);
+
+protected:
+  /// luminance planes of pyramid levels
+  std::vector<ARUint8> pyramid[maxLevels + 1];
+
+  /**
+      Moves contour of square to full resolution and refines its points.
+      \param handle handle used for detection
+      \param square square found in downsampled image
+      \param luma   full resolution luminance plane
+  */
+  void refineSquare (ARHandle * handle, ARMarkerInfo2 & square, const ARUint8 * luma) const;
+};
+
+}
@@ -0,0 +1,213 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "RegionDetector.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace ARTKBlender
+{
+
+// extend region by other region
+void ImageRegion::merge (const ImageRegion & other)
+{
+  int right = std::max(x + width, other.x + other.width);
+  int bottom = std::max(y + height, other.y + other.height);
+  x = std::min(x, other.x);
+  y = std::min(y, other.y);
+  width = right - x;
+  height = bottom - y;
+}
+
+
+// detect squares inside region of image
+int detectSquaresInRegion (ARHandle * handle, ARUint8 * image, const ImageRegion & region,
+  std::vector<ARUint8> & work)
+{
+  // copy region to work buffer, so it can be labeled as separate image, the whole image is labeled in place
+  const size_t pixelSize = handle->arPixelSize;
+  ARUint8 * regionImage = image;
+  if (region.width != handle->xsize || region.height != handle->ysize)
+  {
+    const size_t rowSize = region.width * pixelSize;
+    work.resize(rowSize * region.height);
+    const ARUint8 * src = image + (region.y * handle->xsize + region.x) * pixelSize;
+    for (int row = 0; row < region.height; ++row, src += handle->xsize * pixelSize)
+      std::memcpy(work.data() + row * rowSize, src, rowSize);
+    regionImage = work.data();
+  }
+
+  // label region and find squares
+  if (arLabeling(regionImage, region.width, region.height, handle->arPixelFormat, handle->arDebug,
+      handle->arLabelingMode, handle->arLabelingThresh, handle->arImageProcMode, &handle->labelInfo, NULL) < 0)
+    return -1;
+  int squareNum = 0;
+  if (arDetectMarker2(region.width, region.height, &handle->labelInfo, handle->arImageProcMode,
+      AR_AREA_MAX, AR_AREA_MIN, AR_SQUARE_FIT_THRESH, handle->markerInfo2, &squareNum) < 0)
+    return -1;
+
+  // move squares to image coordinates, field image processing finds them in half resolution of even region
+  const int scale = handle->arImageProcMode == AR_IMAGE_PROC_FIELD_IMAGE ? 2 : 1;
+  const int left = region.x / scale, top = region.y / scale;
+  for (int i = 0; i < squareNum; ++i)
+  {
+    ARMarkerInfo2 & square = handle->markerInfo2[i];
+    square.pos[0] += left;
+    square.pos[1] += top;
+    for (int j = 0; j < square.coord_num; ++j)
+    {
+      square.x_coord[j] += left;
+      square.y_coord[j] += top;
+    }
+  }
+  return squareNum;
+}
+
+// detect markers inside regions of image
+bool detectMarkersInRegions (ARHandle * handle, ARUint8 * image, const std::vector<ImageRegion> & regions,
+  std::vector<ARUint8> & work)
+{
+  handle->marker_num = 0;
+  handle->marker2_num = 0;
+  for (auto & region : regions)
+  {
+    // find squares of region
+    int squareNum = detectSquaresInRegion(handle, image, region, work);
+    if (squareNum < 0)
+      return false;
+    squareNum = std::min(squareNum, AR_SQUARE_MAX - handle->marker_num);
+
+    // match patterns of squares in full image
+    int markerNum = 0;
+    if (squareNum > 0 && arGetMarkerInfo(image, handle->xsize, handle->ysize, handle->arPixelFormat,
+        handle->markerInfo2, squareNum, handle->pattHandle, handle->arImageProcMode,
+        handle->arPatternDetectionMode, &handle->arParamLT->paramLTf, handle->pattRatio,
+        handle->markerInfo + handle->marker_num, &markerNum, handle->matrixCodeType) < 0)
+      return false;
+    handle->marker_num += markerNum;
+  }
+  return true;
+}
+
+// get padded region around marker
+ImageRegion getMarkerRegion (const ARMarkerInfo & marker, double padding, int xsize, int ysize)
+{
+  // bounding box of marker vertices
+  double minX = marker.vertex[0][0], maxX = minX;
+  double minY = marker.vertex[0][1], maxY = minY;
+  for (int i = 1; i < 4; ++i)
+  {
+    minX = std::min(minX, marker.vertex[i][0]);
+    maxX = std::max(maxX, marker.vertex[i][0]);
+    minY = std::min(minY, marker.vertex[i][1]);
+    maxY = std::max(maxY, marker.vertex[i][1]);
+  }
+  // add padding, relative to marker size
+  double pad = padding * std::max(maxX - minX, maxY - minY) + 2.0;
+  // clip to image, coordinates are even to keep field image processing aligned
+  int left = std::max(0, int(std::floor(minX - pad))) & ~1;
+  int top = std::max(0, int(std::floor(minY - pad))) & ~1;
+  int right = std::min(xsize, int(std::ceil(maxX + pad)) + 1);
+  int bottom = std::min(ysize, int(std::ceil(maxY + pad)) + 1);
+  ImageRegion region = { left, top, std::max(0, right - left), std::max(0, bottom - top) };
+  return region;
+}
+
+// merge overlapping regions
+void mergeRegions (std::vector<ImageRegion> & regions)
+{
+  bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (size_t i = 0; i < regions.size() && !merged; ++i)
+      for (size_t j = i + 1; j < regions.size() && !merged; ++j)
+        if (regions[i].overlaps(regions[j]))
+        {
+          regions[i].merge(regions[j]);
+          regions.erase(regions.begin() + j);
+          merged = true;
+        }
+  }
+}
+
+
+// implementation of RegionTracker
+
+// constructor
+RegionTracker::RegionTracker (void)
+  : enabled(false), padding(0.5), fullScanInterval(30), fullScans(0), regionScans(0),
+    trackedMarkers(0), framesSinceFullScan(0)
+{}
+
+// detect markers in regions of previous detection
+bool RegionTracker::detectRegions (ARHandle * handle, ARUint8 * image)
+{
+  // check if full scan is due
+  if (regions.empty() || framesSinceFullScan >= fullScanInterval)
+    return false;
+  // detect markers in regions, automatic threshold is kept from the last full scan
+  if (!detectMarkersInRegions(handle, image, regions, work))
+    return false;
+  ++regionScans;
+  ++framesSinceFullScan;
+  // keep result, if no marker was lost
+  int previousMarkers = trackedMarkers;
+  return updateRegions(handle) >= previousMarkers;
+}
+
+// update regions after full scan
+void RegionTracker::fullScanDone (ARHandle * handle)
+{
+  ++fullScans;
+  framesSinceFullScan = 0;
+  updateRegions(handle);
+}
+
+// forget previous regions
+void RegionTracker::reset (void)
+{
+  regions.clear();
+  trackedMarkers = 0;
+  framesSinceFullScan = 0;
+}
+
+// compute regions of identified markers
+int RegionTracker::updateRegions (ARHandle * handle)
+{
+  regions.clear();
+  trackedMarkers = 0;
+  for (int i = 0; i < handle->marker_num; ++i)
+  {
+    if (handle->markerInfo[i].id < 0)
+      continue;
+    ++trackedMarkers;
+    ImageRegion region = getMarkerRegion(handle->markerInfo[i], padding, handle->xsize, handle->ysize);
+    if (region.width > 0 && region.height > 0)
+      regions.push_back(region);
+  }
+  mergeRegions(regions);
+  return trackedMarkers;
+}
+
+}
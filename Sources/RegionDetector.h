@@ -0,0 +1,167 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/// rectangular region of image
+struct ImageRegion
+{
+  /// left column
+  int x;
+  /// top row
+  int y;
+  /// width in pixels
+  int width;
+  /// height in pixels
+  int height;
+
+  /**
+      Checks if regions overlap.
+      \param other other region
+      \return true, if regions have common pixels
+  */
+  bool overlaps (const ImageRegion & other) const
+  {
+    return x < other.x + other.width && other.x < x + width && y < other.y + other.height && other.y < y + height;
+  }
+
+  /**
+      Extends region to contain other region.
+      \param other other region
+  */
+  void merge (const ImageRegion & other);
+};
+
+/**
+    Finds squares inside region of image. Region is copied to work buffer,
+    unless it's the whole image, labeled and found squares are moved to image
+    coordinates, which are halved in field image processing mode. Squares are
+    stored in markerInfo2 array of handle.
+    \param handle handle used for detection
+    \param image  full image data
+    \param region region to search
+    \param work   work buffer, it's resized when needed
+    \return number of found squares, -1 if labeling failed
+*/
+int detectSquaresInRegion (ARHandle * handle, ARUint8 * image, const ImageRegion & region,
+  std::vector<ARUint8> & work);
+
+/**
+    Detects markers only inside regions of image. Every region is copied to work
+    buffer, where labeling and square extraction is performed. Found squares are
+    moved to image coordinates and their patterns are matched in full image.
+    Results are stored in handle as by arDetectMarker.
+    \param handle  handle used for detection
+    \param image   full image data
+    \param regions regions to search, they shouldn't overlap
+    \param work    work buffer, it's resized when needed
+    \return true, if detection was successful
+*/
+bool detectMarkersInRegions (ARHandle * handle, ARUint8 * image, const std::vector<ImageRegion> & regions,
+  std::vector<ARUint8> & work);
+
+/**
+    Computes padded search region around marker.
+    \param marker  detected marker
+    \param padding padding relative to marker size
+    \param xsize   width of image
+    \param ysize   height of image
+    \return region clipped to image
+*/
+ImageRegion getMarkerRegion (const ARMarkerInfo & marker, double padding, int xsize, int ysize);
+
+/**
+    Merges overlapping regions, so every pixel is in one region at most.
+    \param regions regions to merge
+*/
+void mergeRegions (std::vector<ImageRegion> & regions);
+
+
+/**
+    Region of interest tracking of markers.
+
+    Markers detected in previous frame define padded search regions, only these
+    regions are labeled in next frame. Full frame is scanned periodically, when
+    no marker was detected or when some marker was lost.
+*/
+class RegionTracker
+{
+public:
+  /**
+      Constructor sets default parameters, tracking is disabled.
+  */
+  RegionTracker (void);
+
+  /// tracking is enabled
+  bool enabled;
+  /// padding of search regions relative to marker size
+  double padding;
+  /// maximal number of frames between full frame scans
+  int fullScanInterval;
+  /// number of full frame scans
+  unsigned long long fullScans;
+  /// number of scans of regions only
+  unsigned long long regionScans;
+
+  /**
+      Detects markers in regions of previous detection, if full scan isn't due.
+      \param handle handle used for detection
+      \param image  image data
+      \return true, if markers were detected, false, if full scan is required
+  */
+  bool detectRegions (ARHandle * handle, ARUint8 * image);
+
+  /**
+      Updates regions after full scan of image.
+      \param handle handle with detected markers
+  */
+  void fullScanDone (ARHandle * handle);
+
+  /**
+      Forgets regions of previous detection, so next frame is scanned fully.
+  */
+  void reset (void);
+
+protected:
+  /// search regions from previous detection
+  std::vector<ImageRegion> regions;
+  /// number of identified markers in previous detection
+  int trackedMarkers;
+  /// number of frames since last full scan
+  int framesSinceFullScan;
+  /// work buffer for region images
+  std::vector<ARUint8> work;
+
+  /**
+      Counts identified markers and computes search regions from them.
+      \param handle handle with detected markers
+      \return number of identified markers
+  */
+  int updateRegions (ARHandle * handle);
+};
+
+}
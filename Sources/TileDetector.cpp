@@ -0,0 +1,249 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "TileDetector.h"
+
+#include "ImageUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ARTKBlender
+{
+
+// copy contour and vertices of square
+static void copySquare (ARMarkerInfo2 & target, const ARMarkerInfo2 & source)
+{
+  target.area = source.area;
+  target.pos[0] = source.pos[0];
+  target.pos[1] = source.pos[1];
+  target.coord_num = source.coord_num;
+  std::memcpy(target.x_coord, source.x_coord, source.coord_num * sizeof(source.x_coord[0]));
+  std::memcpy(target.y_coord, source.y_coord, source.coord_num * sizeof(source.y_coord[0]));
+  std::memcpy(target.vertex, source.vertex, sizeof(source.vertex));
+}
+
+// get padded bounding box of square clipped to image, contour is scaled from field coordinates
+static ImageRegion getSquareRegion (const ARMarkerInfo2 & square, int scale, int xsize, int ysize)
+{
+  int minX = xsize, maxX = 0, minY = ysize, maxY = 0;
+  for (int i = 0; i < square.coord_num; ++i)
+  {
+    minX = std::min(minX, square.x_coord[i] * scale);
+    maxX = std::max(maxX, square.x_coord[i] * scale + scale - 1);
+    minY = std::min(minY, square.y_coord[i] * scale);
+    maxY = std::max(maxY, square.y_coord[i] * scale + scale - 1);
+  }
+  // coordinates are even to keep field image processing aligned
+  int left = std::max(0, minX - 2) & ~1;
+  int top = std::max(0, minY - 2) & ~1;
+  int right = std::min(xsize, maxX + 3);
+  int bottom = std::min(ysize, maxY + 3);
+  ImageRegion region = { left, top, std::max(0, right - left), std::max(0, bottom - top) };
+  return region;
+}
+
+
+// implementation of TileDetector
+
+// constructor
+TileDetector::TileDetector (void)
+  : enabled(false), tileSize(32), threshold(4.0), fullScanInterval(30), fullScans(0), incrementalScans(0),
+    comparedTiles(0), changedTiles(0), referenceKey(), squareNum(0), framesSinceFullScan(0)
+{}
+
+// detect markers in changed tiles of image
+bool TileDetector::detect (ARHandle * handle, ARUint8 * image)
+{
+  if (reference.empty() || !(getKey(handle) == referenceKey) || framesSinceFullScan >= fullScanInterval)
+  {
+    // full scan keeps its squares and image for next frames
+    reset();
+    if (arDetectMarker(handle, image) < 0)
+      return false;
+    storeSquares(handle, handle->marker2_num);
+    reference.assign(image, image + size_t(handle->xsize) * handle->ysize * handle->arPixelSize);
+    referenceKey = getKey(handle);
+    ++fullScans;
+    return true;
+  }
+
+  // label changed regions, squares in them are found again
+  findChangedRegions(handle, image);
+  releaseSquares();
+  for (auto & region : regions)
+  {
+    int count = detectSquaresInRegion(handle, image, region, work);
+    if (count < 0)
+    {
+      reset();
+      return false;
+    }
+    storeSquares(handle, count);
+  }
+  ++incrementalScans;
+  ++framesSinceFullScan;
+
+  // match patterns of all squares in full image
+  for (int i = 0; i < squareNum; ++i)
+    copySquare(handle->markerInfo2[i], squares[i]);
+  handle->marker2_num = squareNum;
+  handle->marker_num = 0;
+  return squareNum == 0 || arGetMarkerInfo(image, handle->xsize, handle->ysize, handle->arPixelFormat,
+    handle->markerInfo2, squareNum, handle->pattHandle, handle->arImageProcMode, handle->arPatternDetectionMode,
+    &handle->arParamLT->paramLTf, handle->pattRatio, handle->markerInfo, &handle->marker_num,
+    handle->matrixCodeType) >= 0;
+}
+
+// forget reference image and squares
+void TileDetector::reset (void)
+{
+  reference.clear();
+  squareNum = 0;
+  framesSinceFullScan = 0;
+}
+
+// compare image with reference image and find regions of changed tiles
+void TileDetector::findChangedRegions (ARHandle * handle, const ARUint8 * image)
+{
+  const int xsize = handle->xsize, ysize = handle->ysize;
+  const size_t pixelSize = handle->arPixelSize, pitch = xsize * pixelSize;
+  const int cols = (xsize + tileSize - 1) / tileSize, rows = (ysize + tileSize - 1) / tileSize;
+
+  // compare tiles, changed tiles are copied to reference image, so slow changes accumulate in other tiles
+  tiles.assign(size_t(cols) * rows, 0);
+  for (int ty = 0; ty < rows; ++ty)
+  {
+    const int y = ty * tileSize, height = std::min(tileSize, ysize - y);
+    for (int tx = 0; tx < cols; ++tx)
+    {
+      const int x = tx * tileSize, width = std::min(tileSize, xsize - x);
+      const size_t offset = y * pitch + x * pixelSize, rowSize = width * pixelSize;
+      ARUint8 * tile = reference.data() + offset;
+      if (double(sumAbsDiff(image + offset, tile, pitch, rowSize, height)) <= threshold * rowSize * height)
+        continue;
+      tiles[ty * cols + tx] = 1;
+      for (int row = 0; row < height; ++row)
+        std::memcpy(tile + row * pitch, image + offset + row * pitch, rowSize);
+      ++changedTiles;
+    }
+  }
+  comparedTiles += tiles.size();
+
+  // mark neighbours of changed tiles
+  changed.assign(tiles.size(), 0);
+  for (int ty = 0; ty < rows; ++ty)
+    for (int tx = 0; tx < cols; ++tx)
+      if (tiles[ty * cols + tx])
+        for (int ny = std::max(0, ty - 1); ny <= std::min(rows - 1, ty + 1); ++ny)
+          for (int nx = std::max(0, tx - 1); nx <= std::min(cols - 1, tx + 1); ++nx)
+            changed[ny * cols + nx] = 1;
+
+  // bounding boxes of connected marked tiles are regions
+  regions.clear();
+  for (int start = 0; start < cols * rows; ++start)
+  {
+    if (changed[start] != 1)
+      continue;
+    int left = cols, top = rows, right = 0, bottom = 0;
+    fillStack.push_back(start);
+    changed[start] = 2;
+    while (!fillStack.empty())
+    {
+      int index = fillStack.back(), tx = index % cols, ty = index / cols;
+      fillStack.pop_back();
+      left = std::min(left, tx);
+      right = std::max(right, tx);
+      top = std::min(top, ty);
+      bottom = std::max(bottom, ty);
+      const int neighbours[4][2] = { { tx - 1, ty }, { tx + 1, ty }, { tx, ty - 1 }, { tx, ty + 1 } };
+      for (auto & n : neighbours)
+        if (n[0] >= 0 && n[0] < cols && n[1] >= 0 && n[1] < rows && changed[n[1] * cols + n[0]] == 1)
+        {
+          changed[n[1] * cols + n[0]] = 2;
+          fillStack.push_back(n[1] * cols + n[0]);
+        }
+    }
+    // regions overlap by one pixel, when they touch, so they are merged
+    int x = left * tileSize, y = top * tileSize;
+    ImageRegion region = { x, y, std::min(xsize, (right + 1) * tileSize + 1) - x,
+      std::min(ysize, (bottom + 1) * tileSize + 1) - y };
+    regions.push_back(region);
+  }
+}
+
+// extend regions by squares overlapping them
+void TileDetector::releaseSquares (void)
+{
+  bool extended = true;
+  while (extended)
+  {
+    mergeRegions(regions);
+    extended = false;
+    for (int i = 0; i < squareNum; )
+    {
+      bool overlaps = std::any_of(regions.begin(), regions.end(),
+        [&](const ImageRegion & region) { return region.overlaps(squareRegions[i]); });
+      if (!overlaps)
+      {
+        ++i;
+        continue;
+      }
+      // the last square replaces released one
+      regions.push_back(squareRegions[i]);
+      if (--squareNum != i)
+      {
+        copySquare(squares[i], squares[squareNum]);
+        squareRegions[i] = squareRegions[squareNum];
+      }
+      extended = true;
+    }
+  }
+}
+
+// store squares found in handle
+void TileDetector::storeSquares (ARHandle * handle, int count)
+{
+  count = std::min(count, AR_SQUARE_MAX - squareNum);
+  if (squares.size() < size_t(squareNum + count))
+  {
+    squares.resize(squareNum + count);
+    squareRegions.resize(squareNum + count);
+  }
+  for (int i = 0; i < count; ++i, ++squareNum)
+  {
+    copySquare(squares[squareNum], handle->markerInfo2[i]);
+    squareRegions[squareNum] = getSquareRegion(handle->markerInfo2[i],
+      handle->arImageProcMode == AR_IMAGE_PROC_FIELD_IMAGE ? 2 : 1, handle->xsize, handle->ysize);
+  }
+}
+
+// get labeling settings of handle
+TileDetector::LabelingKey TileDetector::getKey (ARHandle * handle)
+{
+  // automatic threshold is recomputed by every full scan, incremental scans keep it
+  LabelingKey key = { handle->xsize, handle->ysize, handle->arPixelFormat, handle->arImageProcMode,
+    handle->arLabelingMode, handle->arLabelingThreshMode,
+    handle->arLabelingThreshMode == AR_LABELING_THRESH_MODE_MANUAL ? handle->arLabelingThresh : -1 };
+  return key;
+}
+
+}
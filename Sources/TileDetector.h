@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <vector>
+
+#include "RegionDetector.h"
+
+namespace ARTKBlender
+{
+
+/**
+    Incremental detection of markers in frames of static camera.
+
+    Image is split to tiles compared with reference image by sum of absolute
+    differences. Only changed tiles with their neighbours are labeled, squares
+    of previous frames outside of them are reused. Patterns of all squares are
+    matched in full image, so markers are identified in every frame. Full image
+    is scanned periodically and when labeling settings change. Markers of
+    incremental scans are taken from pattern matching directly, confidence
+    cutoff and tracking history of arDetectMarker are applied only by full
+    scans.
+*/
+class TileDetector
+{
+public:
+  /// minimal size of tiles
+  static const int minTileSize = 8;
+  /// maximal size of tiles
+  static const int maxTileSize = 256;
+
+  /**
+      Constructor sets default parameters, incremental detection is disabled.
+  */
+  TileDetector (void);
+
+  /// incremental detection is enabled
+  bool enabled;
+  /// width and height of tiles in pixels, it's even
+  int tileSize;
+  /// mean absolute difference of tile bytes, above which tile is changed
+  double threshold;
+  /// maximal number of frames between full frame scans
+  int fullScanInterval;
+  /// number of full frame scans
+  unsigned long long fullScans;
+  /// number of incremental scans
+  unsigned long long incrementalScans;
+  /// number of tiles compared by incremental scans
+  unsigned long long comparedTiles;
+  /// number of changed tiles
+  unsigned long long changedTiles;
+
+  /**
+      Detects markers in image, results are stored in handle as by arDetectMarker.
+      \param handle handle used for detection
+      \param image  image data
+      \return true, if detection was successful
+  */
+  bool detect (ARHandle * handle, ARUint8 * image);
+
+  /**
+      Forgets reference image and squares, so next frame is scanned fully.
+  */
+  void reset (void);
+
+protected:
+  /// labeling settings of reference image
+  struct LabelingKey
+  {
+    int xsize, ysize, pixelFormat, imageProcMode, labelingMode, labelingThreshMode, labelingThresh;
+
+    bool operator== (const LabelingKey & other) const
+    {
+      return xsize == other.xsize && ysize == other.ysize && pixelFormat == other.pixelFormat &&
+        imageProcMode == other.imageProcMode && labelingMode == other.labelingMode &&
+        labelingThreshMode == other.labelingThreshMode && labelingThresh == other.labelingThresh;
+    }
+  };
+
+  /// image compared with next frame, changed tiles are updated
+  std::vector<ARUint8> reference;
+  /// labeling settings of reference image
+  LabelingKey referenceKey;
+  /// squares found in previous frames
+  std::vector<ARMarkerInfo2> squares;
+  /// padded bounding boxes of squares
+  std::vector<ImageRegion> squareRegions;
+  /// number of valid squares
+  int squareNum;
+  /// flags of changed tiles
+  std::vector<char> tiles;
+  /// flags of changed tiles and their neighbours
+  std::vector<char> changed;
+  /// regions of changed tiles
+  std::vector<ImageRegion> regions;
+  /// indices of tiles waiting in flood fill of regions
+  std::vector<int> fillStack;
+  /// number of frames since last full scan
+  int framesSinceFullScan;
+  /// work buffer for region images
+  std::vector<ARUint8> work;
+
+  /**
+      Compares image with reference image, updates changed tiles of reference
+      image and computes regions of changed tiles and their neighbours.
+      \param handle handle used for detection
+      \param image  image data
+  */
+  void findChangedRegions (ARHandle * handle, const ARUint8 * image);
+
+  /**
+      Extends regions by squares overlapping them, the squares are removed.
+  */
+  void releaseSquares (void);
+
+  /**
+      Stores squares found in handle.
+      \param handle handle with found squares
+      \param count  number of found squares
+  */
+  void storeSquares (ARHandle * handle, int count);
+
+  /**
+      Gets labeling settings of handle.
+      \param handle handle used for detection
+      \return labeling settings
+  */
+  static LabelingKey getKey (ARHandle * handle);
+};
+
+}
@@ -0,0 +1,172 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "TrackingThread.h"
+
+#include "ARHandle.h"
+#include "ImageUtils.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ARTKBlender
+{
+
+// constructor
+TrackingThread::TrackingThread (PyARHandle * handle, size_t frameSize)
+  : handle(handle), pendingSlot(-1), processingSlot(-1), lastSubmitted(0), droppedFrames(0),
+    stopping(false), resultMarkers(AR_SQUARE_MAX), resultNum(0), resultSequence(0), resultTime(0.0)
+{
+  // allocate frame slots
+  for (int i = 0; i < slotCount; ++i)
+  {
+    frames[i].resize(frameSize);
+    frameSequence[i] = 0;
+    frameTime[i] = 0.0;
+  }
+  // start worker
+  worker = std::thread(&TrackingThread::workerLoop, this);
+}
+
+// destructor
+TrackingThread::~TrackingThread (void)
+{
+  // signal worker to stop
+  {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    stopping = true;
+  }
+  frameCondition.notify_one();
+  worker.join();
+}
+
+// submit frame for detection
+unsigned long long TrackingThread::submit (const ARUint8 * data, size_t rowSize, size_t rows, ptrdiff_t pitch,
+  double timestamp)
+{
+  std::lock_guard<std::mutex> submitLock(submitMutex);
+  // frame size could be changed by resize after rows were validated
+  if (rowSize * rows != frames[0].size())
+    return 0;
+  // find slot neither waiting for detection nor processed
+  int freeSlot = 0;
+  {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    while (freeSlot == pendingSlot || freeSlot == processingSlot)
+      ++freeSlot;
+  }
+  // copy frame data, the slot isn't used by worker
+  if (pitch == 0)
+    std::memcpy(frames[freeSlot].data(), data, frames[freeSlot].size());
+  else
+    packRows(data, pitch, frames[freeSlot].data(), rowSize, rows);
+  // make slot pending, older pending frame is dropped
+  unsigned long long sequence;
+  {
+    std::lock_guard<std::mutex> lock(slotMutex);
+    if (pendingSlot >= 0)
+      ++droppedFrames;
+    sequence = ++lastSubmitted;
+    frameSequence[freeSlot] = sequence;
+    frameTime[freeSlot] = timestamp;
+    pendingSlot = freeSlot;
+  }
+  frameCondition.notify_one();
+  return sequence;
+}
+
+// get the most recent result
+unsigned long long TrackingThread::getResult (unsigned long long lastSequence, ARMarkerInfo * markers, int & markerNum,
+  double & timestamp)
+{
+  std::lock_guard<std::mutex> lock(resultMutex);
+  if (resultSequence > lastSequence)
+  {
+    std::copy(resultMarkers.begin(), resultMarkers.begin() + resultNum, markers);
+    markerNum = resultNum;
+    timestamp = resultTime;
+  }
+  return resultSequence;
+}
+
+// change size of frame slots
+void TrackingThread::resize (size_t frameSize)
+{
+  std::lock_guard<std::mutex> submitLock(submitMutex);
+  std::lock_guard<std::mutex> lock(slotMutex);
+  // drop pending frame and frame taken by worker waiting for handle
+  if (pendingSlot >= 0)
+  {
+    ++droppedFrames;
+    pendingSlot = -1;
+  }
+  if (processingSlot >= 0 && frameSequence[processingSlot] != 0)
+  {
+    ++droppedFrames;
+    frameSequence[processingSlot] = 0;
+  }
+  // capacity of slots is kept, when frames get smaller
+  for (int i = 0; i < slotCount; ++i)
+    frames[i].resize(frameSize);
+}
+
+// get number of dropped frames
+unsigned long long TrackingThread::getDroppedFrames (void)
+{
+  std::lock_guard<std::mutex> lock(slotMutex);
+  return droppedFrames;
+}
+
+// worker thread function
+void TrackingThread::workerLoop (void)
+{
+  for (;;)
+  {
+    // wait for pending frame
+    int slot;
+    {
+      std::unique_lock<std::mutex> lock(slotMutex);
+      frameCondition.wait(lock, [this] { return stopping || pendingSlot >= 0; });
+      if (stopping)
+        return;
+      slot = processingSlot = pendingSlot;
+      pendingSlot = -1;
+    }
+    // detect markers and store result
+    {
+      std::lock_guard<std::mutex> handleLock(*handle->lock);
+      // frame dropped by resize has sequence number 0, result of skipped identical frame is kept
+      if (frameSequence[slot] != 0 && detectMarkers(handle, frames[slot].data()) && !handle->frameSkipped)
+      {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        resultNum = arGetMarkerNum(handle->handle);
+        std::copy(arGetMarker(handle->handle), arGetMarker(handle->handle) + resultNum, resultMarkers.begin());
+        resultSequence = frameSequence[slot];
+        resultTime = frameTime[slot];
+      }
+    }
+    // release slot
+    std::lock_guard<std::mutex> lock(slotMutex);
+    processingSlot = -1;
+  }
+}
+
+}
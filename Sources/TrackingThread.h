@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <AR/ar.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+struct PyARHandle;
+
+/**
+    Persistent worker thread detecting markers of ARHandle in background.
+
+    Submitted frames are copied to one of three frame slots, so submission
+    never waits for detection. If newer frame is submitted before worker picks
+    up the older one, the older frame is dropped. Results of the most recent
+    completed detection are stored with sequence number of their frame.
+*/
+class TrackingThread
+{
+public:
+  /**
+      Constructor starts worker thread.
+      \param handle    handle used for detection
+      \param frameSize size of frame data in bytes
+  */
+  TrackingThread (PyARHandle * handle, size_t frameSize);
+
+  /**
+      Destructor stops and joins worker thread.
+  */
+  ~TrackingThread (void);
+
+  /**
+      Copies rows of frame to free slot and schedules it for detection.
+      \param data      first row of frame data
+      \param rowSize   size of row in bytes
+      \param rows      number of rows
+      \param pitch     distance of rows in bytes, 0 for packed rows
+      \param timestamp capture time of frame in seconds
+      \return sequence number of frame, 0 if rows don't match frame size
+  */
+  unsigned long long submit (const ARUint8 * data, size_t rowSize, size_t rows, ptrdiff_t pitch, double timestamp);
+
+  /**
+      Copies markers of the most recent completed detection, if it's newer
+      than given sequence number.
+      \param lastSequence sequence number of already retrieved result
+      \param markers      array of AR_SQUARE_MAX markers to fill
+      \param markerNum    number of copied markers
+      \param timestamp    capture time of frame of copied markers
+      \return sequence number of the most recent result, 0 if there's none
+  */
+  unsigned long long getResult (unsigned long long lastSequence, ARMarkerInfo * markers, int & markerNum,
+    double & timestamp);
+
+  /**
+      Changes size of frame slots, frames of previous size are dropped. It's
+      called with locked handle, so worker isn't detecting.
+      \param frameSize size of frame data in bytes
+  */
+  void resize (size_t frameSize);
+
+  /**
+      Provides number of frames dropped before detection.
+      \return number of dropped frames
+  */
+  unsigned long long getDroppedFrames (void);
+
+protected:
+  /// number of frame slots
+  static const int slotCount = 3;
+
+  /// handle used for detection
+  PyARHandle * handle;
+  /// worker thread
+  std::thread worker;
+  /// frame data slots
+  std::vector<ARUint8> frames[slotCount];
+  /// sequence numbers of frames in slots
+  unsigned long long frameSequence[slotCount];
+  /// capture times of frames in slots
+  double frameTime[slotCount];
+  /// slot waiting for detection, -1 if none
+  int pendingSlot;
+  /// slot processed by worker, -1 if none
+  int processingSlot;
+  /// sequence number of last submitted frame
+  unsigned long long lastSubmitted;
+  /// number of dropped frames
+  unsigned long long droppedFrames;
+  /// flag to stop worker thread
+  bool stopping;
+  /// mutex guarding slots state
+  std::mutex slotMutex;
+  /// mutex serializing submissions
+  std::mutex submitMutex;
+  /// condition signalling pending frame or stop of thread
+  std::condition_variable frameCondition;
+
+  /// mutex guarding result, it's never held while waiting for other locks
+  std::mutex resultMutex;
+  /// markers of the most recent result
+  std::vector<ARMarkerInfo> resultMarkers;
+  /// number of markers in result
+  int resultNum;
+  /// sequence number of frame of the most recent result
+  unsigned long long resultSequence;
+  /// capture time of frame of the most recent result
+  double resultTime;
+
+  /**
+      Function of worker thread.
+  */
+  void workerLoop (void);
+};
+
+}
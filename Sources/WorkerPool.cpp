@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#include "WorkerPool.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ARTKBlender
+{
+
+// constructor
+WorkerPool::WorkerPool (size_t threadCount, bool pinThreads)
+  : runTask(nullptr), runContext(nullptr), runCount(0), nextIndex(0), activeWorkers(0),
+    runNumber(0), stopping(false)
+{
+  size_t coreCount = std::thread::hardware_concurrency();
+  if (coreCount == 0)
+    coreCount = 1;
+  if (threadCount == 0)
+    threadCount = coreCount;
+  // start worker threads
+  workers.reserve(threadCount);
+  for (size_t i = 0; i < threadCount; ++i)
+  {
+    workers.emplace_back(&WorkerPool::workerLoop, this);
+    if (pinThreads)
+      pinThread(workers.back(), i % coreCount);
+  }
+}
+
+// destructor
+WorkerPool::~WorkerPool (void)
+{
+  // signal workers to stop
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    stopping = true;
+  }
+  startCondition.notify_all();
+  // wait for workers
+  for (auto & worker : workers)
+    worker.join();
+}
+
+// run task in worker threads
+void WorkerPool::run (Task task, void * context, size_t count)
+{
+  if (count == 0)
+    return;
+  std::unique_lock<std::mutex> lock(poolMutex);
+  // prepare new run
+  runTask = task;
+  runContext = context;
+  runCount = count;
+  nextIndex = 0;
+  activeWorkers = workers.size();
+  ++runNumber;
+  startCondition.notify_all();
+  // wait until all workers are done, so no worker touches data of this run later
+  doneCondition.wait(lock, [this] { return activeWorkers == 0; });
+}
+
+// worker thread function
+void WorkerPool::workerLoop (void)
+{
+  unsigned lastRun = 0;
+  std::unique_lock<std::mutex> lock(poolMutex);
+  for (;;)
+  {
+    // wait for new run
+    startCondition.wait(lock, [this, lastRun] { return stopping || runNumber != lastRun; });
+    if (stopping)
+      return;
+    lastRun = runNumber;
+    // process task calls until all are taken
+    while (nextIndex < runCount)
+    {
+      size_t index = nextIndex++;
+      lock.unlock();
+      runTask(runContext, index);
+      lock.lock();
+    }
+    // report end of run
+    if (--activeWorkers == 0)
+      doneCondition.notify_one();
+  }
+}
+
+// pin thread to processor core
+void WorkerPool::pinThread (std::thread & thread, size_t core)
+{
+#ifdef _WIN32
+  SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(core, &cpuSet);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+#endif
+}
+
+}
@@ -0,0 +1,111 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of ARTKBlender library
+
+Copyright (c) 2016 The Zdeno Ash Miklas
+
+ARTKBlender is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Foobar is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ARTKBlender
+{
+
+/**
+    Fixed pool of native worker threads.
+
+    Threads are created once and pinned to processor cores, every call of run
+    reuses them, so no threads are created and nothing is allocated per call.
+*/
+class WorkerPool
+{
+public:
+  /// task function called for every index of a run
+  typedef void (*Task) (void * context, size_t index);
+
+  /**
+      Constructor starts worker threads.
+      \param threadCount number of threads, if 0, number of processor cores is used
+      \param pinThreads  pin every thread to one processor core
+  */
+  WorkerPool (size_t threadCount, bool pinThreads = true);
+
+  /**
+      Destructor stops and joins worker threads.
+  */
+  ~WorkerPool (void);
+
+  /**
+      Provides number of worker threads.
+      \return number of threads
+  */
+  size_t getThreadCount (void) const
+  {
+    return workers.size();
+  }
+
+  /**
+      Runs task for indices from 0 to count - 1 in worker threads and waits
+      until all of them are done.
+      \param task    task function
+      \param context data passed to task function
+      \param count   number of task calls
+  */
+  void run (Task task, void * context, size_t count);
+
+protected:
+  /// worker threads
+  std::vector<std::thread> workers;
+  /// mutex guarding state of pool
+  std::mutex poolMutex;
+  /// condition signalling start of run or stop of pool
+  std::condition_variable startCondition;
+  /// condition signalling that all workers finished run
+  std::condition_variable doneCondition;
+  /// task of current run
+  Task runTask;
+  /// context of current run
+  void * runContext;
+  /// number of task calls in current run
+  size_t runCount;
+  /// index of next task call
+  size_t nextIndex;
+  /// number of workers still processing current run
+  size_t activeWorkers;
+  /// counter of runs, workers use it to detect new run
+  unsigned runNumber;
+  /// flag to stop worker threads
+  bool stopping;
+
+  /**
+      Function of worker thread.
+  */
+  void workerLoop (void);
+
+  /**
+      Pins thread to processor core.
+      \param thread thread to pin
+      \param core   index of processor core
+  */
+  static void pinThread (std::thread & thread, size_t core);
+};
+
+}
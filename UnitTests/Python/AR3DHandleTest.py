@@ -17,6 +17,7 @@
 # along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
 # -----------------------------------------------------------------------------
 
+import array
 import ARTKBlender
 import ARHandleTest
 
@@ -71,3 +72,136 @@ def test_AR3DHandleCalcMatrixCont ():
     return rslt
   mat = handle3D.getTransMatSquareCont(handle.markers[0], 100.0, mat)
   return checkMatrix(mat, vecs, (-10.0, 30.0, -270.0))
+
+def test_AR3DHandleCalcMatrixBatch ():
+  rslt = ARHandleTest.performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  handle3D = ARTKBlender.AR3DHandle(rslt[1])
+  mat = handle3D.getTransMatSquare(handle.markers[0], 100.0)
+  mats, errors = handle3D.getTransMatSquareBatch(handle.markers * 2, (100.0, 100.0))
+  if mats.shape != (2, 4, 4) or len(errors) != 2:
+    return 'Invalid shape of batch results'
+  for i in range(2):
+    rslt = checkMatrix(mats[i].tolist(), ((0.9, -0.3, 0.3),(0.4, 0.7, -0.6),(0.0, 0.65, 0.75)), (7.0, 13.0, -270.0))
+    if rslt != '':
+      return rslt
+    if errors[i] < 0.0:
+      return 'Invalid fit error'
+  out = memoryview(bytearray(16 * 8)).cast('d', (1, 4, 4))
+  rslt = handle3D.getTransMatSquareBatch(handle.markers, 100.0, out=out)
+  if rslt[0] is not out:
+    return 'Supplied output buffer should be returned'
+  if out.tolist()[0] != [list(row) for row in mat]:
+    return 'Batch matrix should match single matrix'
+  try:
+    handle3D.getTransMatSquareBatch(handle.markers * 2, 100.0, out=out)
+    return 'Too small output buffer should be rejected'
+  except ValueError:
+    return ''
+
+def test_AR3DHandlePose ():
+  rslt = ARHandleTest.performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  handle3D = ARTKBlender.AR3DHandle(rslt[1])
+  try:
+    handle3D.poseExpiry = -1.0
+    return 'Negative expiry should be rejected'
+  except ValueError:
+    pass
+  vecs = ((0.9, -0.3, 0.3),(0.4, 0.7, -0.6),(0.0, 0.65, 0.75))
+  for i in range(2):
+    rslt = checkMatrix(handle3D.getPose(handle.markers[0], 100.0), vecs, (7.0, 13.0, -270.0))
+    if rslt != '':
+      return rslt
+  stats = handle3D.poseStats
+  if stats['fresh'] != 1 or stats['continuous'] != 1:
+    return 'The second pose should continue from the first one: ' + str(stats)
+  handle3D.resetPoses()
+  handle3D.getPose(handle.markers[0], 100.0)
+  return '' if handle3D.poseStats['fresh'] == 2 else 'Pose should be solved fresh after reset'
+
+def test_AR3DHandlePredict ():
+  rslt = ARHandleTest.performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  param = rslt[1]
+  handle3D = ARTKBlender.AR3DHandle(param)
+  image = ARHandleTest.loadImage('../../UnitTests/Data/hiro_marker.raw', param.size, 3)
+  if isinstance(image, str):
+    return image
+  timestamp = ARTKBlender.clock()
+  if not handle.detect(image, timestamp):
+    return 'Marker detection failed'
+  if handle.markers[0].timestamp != timestamp or handle.detectionLatency < 0.0:
+    return 'Marker should have timestamp of image'
+  if handle3D.predict(0, timestamp) is not None:
+    return 'No pose should be predicted before getPose'
+  handle3D.getPose(handle.markers[0], 100.0)
+  handle.detect(image, timestamp + 0.02)
+  handle3D.getPose(handle.markers[0], 100.0)
+  vecs = ((0.9, -0.3, 0.3),(0.4, 0.7, -0.6),(0.0, 0.65, 0.75))
+  rslt = checkMatrix(handle3D.predict(0, timestamp + 0.05), vecs, (7.0, 13.0, -270.0))
+  if rslt != '':
+    return rslt
+  return '' if handle3D.predict(0, timestamp + 10.0) is None else 'Expired pose should not be predicted'
+
+def test_AR3DHandlePoseOutput ():
+  rslt = ARHandleTest.performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  handle3D = ARTKBlender.AR3DHandle(rslt[1])
+  mat = handle3D.getTransMatSquare(handle.markers[0], 100.0)
+  for typeCode in ('d', 'f'):
+    out = array.array(typeCode, [0.0] * 16)
+    if handle3D.getTransMatSquare(handle.markers[0], 100.0, out=out) is not out:
+      return 'Output buffer should be returned'
+    for i in range(16):
+      if abs(out[i] - mat[i // 4][i % 4]) > 1e-3:
+        return 'Invalid value in output buffer of type ' + typeCode
+  try:
+    handle3D.getTransMatSquare(handle.markers[0], 100.0, out=array.array('d', [0.0] * 9))
+    return 'Too small output buffer should be rejected'
+  except ValueError:
+    pass
+  quat, trans = handle3D.getTransMatSquare(handle.markers[0], 100.0, quaternion=True)
+  if abs(sum(q * q for q in quat) - 1.0) > 1e-6:
+    return 'Quaternion should be normalized'
+  w, x, y, z = quat
+  if abs(1.0 - 2.0 * (y * y + z * z) - mat[0][0]) > 1e-6 or abs(2.0 * (x * y + w * z) - mat[1][0]) > 1e-6:
+    return 'Quaternion should match matrix'
+  if any(abs(trans[i] - mat[i][3]) > 1e-6 for i in range(3)):
+    return 'Translation should match matrix'
+  out = array.array('d', [0.0] * 7)
+  handle3D.getPose(handle.markers[0], 100.0, out=out, quaternion=True)
+  return '' if abs(out[4] - mat[0][3]) < 1e-3 else 'Invalid translation in output buffer'
+
+def test_AR3DHandleCalcMatrixArgs ():
+  rslt = ARHandleTest.performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  handle3D = ARTKBlender.AR3DHandle(rslt[1])
+  mat = handle3D.getTransMatSquare(width=100.0, marker=handle.markers[0])
+  rslt = checkMatrix(mat, ((0.9, -0.3, 0.3),(0.4, 0.7, -0.6),(0.0, 0.65, 0.75)), (7.0, 13.0, -270.0))
+  if rslt != '':
+    return rslt
+  for args, kwargs in (((), {}), ((handle.markers[0],), {}), ((handle.markers[0], 100.0), { 'width' : 100.0 }),
+      ((handle.markers[0], 100.0), { 'size' : 100.0 }), ((100.0, handle.markers[0]), {})):
+    try:
+      handle3D.getTransMatSquare(*args, **kwargs)
+      return 'Invalid arguments weren\'t rejected'
+    except TypeError:
+      pass
+  # invalid previous matrix raises TypeError
+  try:
+    handle3D.getTransMatSquareCont(handle.markers[0], 100.0, ((1.0, 0.0), (0.0, 1.0)))
+    return 'Invalid matrix wasn\'t rejected'
+  except TypeError:
+    pass
+  return ''
@@ -0,0 +1,75 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+import ARTKBlender
+import ARHandleTest
+
+
+def createHandles (count):
+  handles = []
+  for i in range(count):
+    rslt = ARHandleTest.performMarkerDetection()
+    if isinstance(rslt, str):
+      return rslt
+    handles.append(rslt[0])
+  return handles
+
+def test_ARHandleGroupConstruct ():
+  handles = createHandles(2)
+  if isinstance(handles, str):
+    return handles
+  group = ARTKBlender.ARHandleGroup(handles, threads = 2)
+  if not isinstance(group, ARTKBlender.ARHandleGroup):
+    return 'group isn\'t instance of ARHandleGroup'
+  if group.threadCount != 2:
+    return 'Invalid number of threads'
+  return '' if group.handles == tuple(handles) else 'Invalid handles in group'
+
+def test_ARHandleGroupDuplicateHandle ():
+  handles = createHandles(1)
+  if isinstance(handles, str):
+    return handles
+  try:
+    ARTKBlender.ARHandleGroup(handles * 2)
+  except ValueError:
+    return ''
+  return 'Duplicate handle should be rejected'
+
+def test_ARHandleGroupDetectAll ():
+  handles = createHandles(3)
+  if isinstance(handles, str):
+    return handles
+  image = ARHandleTest.loadImage('../../UnitTests/Data/hiro_marker2.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  group = ARTKBlender.ARHandleGroup(handles)
+  for frame in range(3):
+    if not group.detectAll([image] * len(handles)):
+      return 'Detection failed'
+    for handle in group.handles:
+      if len(handle.markers) != 1 or handle.markers[0].id != 0:
+        return 'Marker not detected'
+  return ''
+
+def test_ARHandleGroupDetectAllInvalidImage ():
+  handles = createHandles(2)
+  if isinstance(handles, str):
+    return handles
+  group = ARTKBlender.ARHandleGroup(handles)
+  return '' if not group.detectAll([b'', b'']) else 'Detection of invalid images should fail'
@@ -18,6 +18,11 @@
 # -----------------------------------------------------------------------------
 
 import ARTKBlender
+import os
+import struct
+import tempfile
+import threading
+import time
 
 
 def test_ARHandleConstruct ():
@@ -62,6 +67,16 @@ def loadImage (imgName, imgSize, pixSize):
     return 'Image data have invalid size = ' + str(len(image))
   return image
 
+def embedImage (image, imgSize, frameSize, origin):
+  # white frame with image at origin
+  rowSize = imgSize[0] * 3
+  frameRowSize = frameSize[0] * 3
+  frame = bytearray(b'\xff' * (frameRowSize * frameSize[1]))
+  for row in range(imgSize[1]):
+    start = (origin[1] + row) * frameRowSize + origin[0] * 3
+    frame[start:start + rowSize] = image[row * rowSize:(row + 1) * rowSize]
+  return bytes(frame)
+
 def detectMarker (handle, image):
   if not handle.detect(image):
     return 'Marker detection failed'
@@ -116,4 +131,570 @@ def test_ARHandleDetect_Camera ():
     return 'Invalid pattern ID'
   if not handle.detect(image):
     return 'Second detection failed'
-  return '' if len(handle.markers) > 0 else 'No marker detected'
\ No newline at end of file
+  return '' if len(handle.markers) > 0 else 'No marker detected'
+
+def test_ARHandleDetect_Threads ():
+  handles = []
+  for i in range(2):
+    rslt = performMarkerDetection()
+    if isinstance(rslt, str):
+      return rslt
+    handles.append(rslt[0])
+  image = loadImage('../../UnitTests/Data/hiro_marker2.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  results = [''] * len(handles)
+  def detectLoop (index):
+    for i in range(10):
+      results[index] = detectMarker(handles[index], image)
+      if results[index] != '':
+        return
+  threads = [threading.Thread(target=detectLoop, args=(i,)) for i in range(len(handles))]
+  for thread in threads:
+    thread.start()
+  for thread in threads:
+    thread.join()
+  for rslt in results:
+    if rslt != '':
+      return rslt
+  return ''
+
+def test_ARHandleTracking ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker2.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  try:
+    handle.submit(image)
+    return 'Submit without tracking should fail'
+  except RuntimeError:
+    pass
+  handle.startTracking()
+  if not handle.tracking:
+    return 'Tracking should be running'
+  if handle.submit(b'') != 0:
+    return 'Invalid image should be rejected'
+  sequence = 0
+  for i in range(5):
+    sequence = handle.submit(image)
+  if sequence != 5:
+    return 'Invalid sequence number'
+  for i in range(500):
+    rslt = handle.poll()
+    if rslt[0] == sequence:
+      break
+    time.sleep(0.01)
+  handle.stopTracking()
+  if handle.tracking:
+    return 'Tracking should be stopped'
+  if rslt[0] != sequence:
+    return 'Last frame wasn\'t processed'
+  if len(rslt[1]) != 1 or rslt[1][0].id != 0:
+    return 'Marker not detected'
+  return '' if handle.markers == rslt[1] else 'Polled markers should be published'
+
+def test_ARHandleRoiTracking ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker2.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  try:
+    handle.roiPadding = -1.0
+    return 'Negative padding should be rejected'
+  except ValueError:
+    pass
+  handle.roiTracking = True
+  handle.roiFullScanInterval = 10
+  for i in range(3):
+    rslt = detectMarker(handle, image)
+    if rslt != '':
+      return rslt
+  stats = handle.roiStats
+  return '' if stats['full'] == 1 and stats['region'] == 2 else 'Invalid numbers of scans: ' + str(stats)
+
+def test_ARHandleRoiTrackingFieldImage ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (400, 320)
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  # marker away from top-left corner, so region offset matters
+  frame = embedImage(image, (254, 207), param.size, (120, 90))
+  handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB)
+  handle.attachPatt = ARTKBlender.ARPattHandle()
+  if handle.attachPatt.load('../../UnitTests/Data/hiro.patt') != 0:
+    return 'Invalid pattern ID'
+  handle.imageProcMode = ARTKBlender.ARImageProcMode.FIELD_IMAGE
+  rslt = detectMarker(handle, frame)
+  if rslt != '':
+    return rslt
+  pos = struct.unpack_from('iii4xddd', handle.markerArray)[4:6]
+  # the first frame is scanned fully, the second one in region of marker
+  handle.roiTracking = True
+  for i in range(2):
+    rslt = detectMarker(handle, frame)
+    if rslt != '':
+      return rslt
+  stats = handle.roiStats
+  if stats['full'] != 1 or stats['region'] != 1:
+    return 'Invalid numbers of scans: ' + str(stats)
+  regionPos = struct.unpack_from('iii4xddd', handle.markerArray)[4:6]
+  if abs(regionPos[0] - pos[0]) > 1.0 or abs(regionPos[1] - pos[1]) > 1.0:
+    return 'Marker found in region is shifted: ' + str(regionPos) + ' instead of ' + str(pos)
+  return ''
+
+def test_ARHandlePyramid ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  if handle.pyramidLevel != 0:
+    return 'Pyramid detection should be disabled by default'
+  for level in (-1, 3):
+    try:
+      handle.pyramidLevel = level
+      return 'Invalid pyramid level should be rejected'
+    except ValueError:
+      pass
+  handle.pyramidLevel = 1
+  if handle.pyramidLevel != 1:
+    return 'Pyramid level not set'
+  rslt = detectMarker(handle, image)
+  if rslt != '':
+    return rslt
+  # adaptive threshold is computed only by full image detection
+  try:
+    handle.labelingThreshMode = ARTKBlender.ARLabelingThreshMode.AUTO_ADAPTIVE
+    return 'Adaptive threshold should be rejected with pyramid'
+  except ValueError:
+    pass
+  handle.labelingThresh = 0
+  handle.labelingThreshMode = ARTKBlender.ARLabelingThreshMode.AUTO_OTSU
+  rslt = detectMarker(handle, image)
+  if rslt != '':
+    return rslt
+  return '' if handle.labelingThresh > 0 else 'Otsu threshold not computed for pyramid'
+
+def test_ARHandleDetectionModes ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  if handle.imageProcMode != ARTKBlender.ARImageProcMode.FRAME_IMAGE:
+    return 'Frame image processing should be default'
+  if handle.labelingMode != ARTKBlender.ARLabelingMode.BLACK_REGION:
+    return 'Black region labeling should be default'
+  invalidValues = (('imageProcMode', 2), ('labelingMode', -1), ('borderSize', 0.5), ('labelingThreshMode', 5),
+    ('labelingThresh', 256), ('patternDetectionMode', 5))
+  for name, value in invalidValues:
+    try:
+      setattr(handle, name, value)
+      return 'Invalid value of ' + name + ' should be rejected'
+    except ValueError:
+      pass
+  handle.imageProcMode = ARTKBlender.ARImageProcMode.FIELD_IMAGE
+  handle.labelingThreshMode = ARTKBlender.ARLabelingThreshMode.AUTO_OTSU
+  handle.patternDetectionMode = ARTKBlender.ARPatternDetectionMode.TEMPLATE_MATCHING_MONO
+  handle.borderSize = 0.25
+  if abs(handle.borderSize - 0.25) > 1e-6:
+    return 'Border size not set'
+  if handle.labelingThreshMode != ARTKBlender.ARLabelingThreshMode.AUTO_OTSU:
+    return 'Labeling threshold mode not set'
+  return detectMarker(handle, image)
+
+def test_ARHandleMarkersPool ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  markersID = id(handle.markers)
+  rslt = detectMarker(handle, image)
+  if rslt != '':
+    return rslt
+  if id(handle.markers) != markersID:
+    return 'Unreferenced markers tuple should be reused'
+  marker = handle.markers[0]
+  markers = handle.markers
+  handle.attachPatt = None
+  handle.detect(image)
+  if handle.markers is markers or handle.markers[0] is marker:
+    return 'Referenced markers should not be reused'
+  if marker.id != 0 or markers[0].id != 0:
+    return 'Referenced markers should keep their data'
+  return '' if handle.markers[0].id < 0 else 'Marker without pattern should not be identified'
+
+def test_ARHandleMarkerArray ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  if len(handle.markerArray) != 1:
+    return 'One marker record should be available'
+  view = memoryview(handle.markerArray)
+  if view.itemsize != 200 or view.shape != (1,) or not view.readonly:
+    return 'Invalid marker array buffer'
+  if not view.format.startswith('T{i:id:'):
+    return 'Invalid marker record format'
+  record = struct.unpack_from('iii4xddd', handle.markerArray)
+  marker = handle.markers[0]
+  if record[0] != marker.id or record[3] != marker.cf:
+    return 'Marker record should match marker'
+  return '' if record[1] > 0 and record[4] > 0.0 and record[5] > 0.0 else 'Invalid area or position of marker'
+
+def test_ARHandleSharedLookupTable ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (333, 222)
+  stats = ARTKBlender.paramLTCacheStats()
+  handles = [ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB) for i in range(3)]
+  shared = ARTKBlender.paramLTCacheStats()
+  if shared['misses'] != stats['misses'] + 1 or shared['hits'] != stats['hits'] + 2:
+    return 'Lookup table isn\'t shared by handles'
+  if shared['memory'] <= stats['memory']:
+    return 'Memory of lookup table isn\'t reported'
+  param.size = (334, 222)
+  handles.append(ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB))
+  if ARTKBlender.paramLTCacheStats()['misses'] != shared['misses'] + 1:
+    return 'Lookup table of other size is shared'
+  del handles
+  stats = ARTKBlender.paramLTCacheStats()
+  return '' if stats['unused'] >= 2 else 'Released lookup tables aren\'t kept'
+
+def test_ARHandleLookupTableSnapshot ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (335, 223)
+  with tempfile.TemporaryDirectory() as tempDir:
+    fileName = os.path.join(tempDir, 'camera_335x223.lt')
+    if not param.saveLookupTable(fileName):
+      return 'Lookup table wasn\'t saved'
+    try:
+      param.saveLookupTable(os.path.join(tempDir, 'missing', 'camera.lt'))
+      return 'Snapshot in missing directory should raise exception'
+    except OSError:
+      pass
+    stats = ARTKBlender.paramLTCacheStats()
+    handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB, lookupTable=fileName)
+    if ARTKBlender.paramLTCacheStats()['mapped'] != stats['mapped'] + 1:
+      return 'Lookup table snapshot isn\'t mapped'
+    del handle
+    # snapshot of other parameters is ignored
+    param.size = (336, 223)
+    handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB, lookupTable=fileName)
+    if ARTKBlender.paramLTCacheStats()['mapped'] != stats['mapped'] + 1:
+      return 'Snapshot of other parameters is mapped'
+    del handle
+    # drop unused mapped table from cache to delete snapshot
+    for i in range(8):
+      param.size = (100 + i, 100)
+      ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB)
+  return ''
+
+def test_ARHandleReconfigure ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (640, 480)
+  handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGBA)
+  pattHandle = ARTKBlender.ARPattHandle()
+  if pattHandle.load('../../UnitTests/Data/hiro.patt') != 0:
+    return 'Invalid pattern ID'
+  handle.attachPatt = pattHandle
+  handle.labelingThresh = 110
+  handle.reconfigure(size = (254, 207), pixelFormat = ARTKBlender.ARPixelFormat.RGB)
+  if handle.size != (254, 207) or handle.pixelFormat != ARTKBlender.ARPixelFormat.RGB:
+    return 'Handle isn\'t reconfigured'
+  if handle.attachPatt != pattHandle or handle.labelingThresh != 110:
+    return 'Settings of handle aren\'t kept'
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  rslt = detectMarker(handle, image)
+  if rslt != '':
+    return rslt
+  handle.reconfigure(pixelFormat = ARTKBlender.ARPixelFormat.RGBA)
+  if handle.size != (254, 207) or handle.detect(image):
+    return 'Image of previous pixel format should be rejected'
+  try:
+    handle.reconfigure(size = (0, 207))
+    return 'Invalid size wasn\'t rejected'
+  except ValueError:
+    pass
+  return ''
+
+def test_ARHandleLumaConversion ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  handle.lumaConversion = True
+  if not handle.lumaConversion or handle.pixelFormat != ARTKBlender.ARPixelFormat.RGB:
+    return 'Pixel format of image data has to be kept'
+  rslt = detectMarker(handle, image)
+  if rslt != '':
+    return rslt
+  # image of color format is still required
+  if handle.detect(image[:handle.size[0] * handle.size[1]]):
+    return 'Luminance image should be rejected'
+  handle.lumaConversion = False
+  return detectMarker(handle, image)
+
+def test_ARHandleStridedImage ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  # rows padded to pitch after header of image data
+  rowSize = handle.size[0] * 3
+  pitch = rowSize + 64
+  offset = 16
+  padded = bytearray(offset + pitch * handle.size[1])
+  for row in range(handle.size[1]):
+    padded[offset + row * pitch:offset + row * pitch + rowSize] = image[row * rowSize:(row + 1) * rowSize]
+  stats = handle.ingestStats
+  if not handle.detect(padded, pitch=pitch, offset=offset) or len(handle.markers) != 1:
+    return 'Marker detection in strided image failed'
+  if handle.ingestStats['repacked'] != stats['repacked'] + 1:
+    return 'Strided image should be repacked'
+  # rows are read by luminance conversion without repacking
+  handle.lumaConversion = True
+  if not handle.detect(padded, pitch=pitch, offset=offset) or len(handle.markers) != 1:
+    return 'Marker detection in converted strided image failed'
+  if handle.ingestStats['converted'] != stats['converted'] + 1 or handle.ingestStats['repacked'] != stats['repacked'] + 1:
+    return 'Strided image should be converted in place'
+  handle.lumaConversion = False
+  # rows outside of buffer are rejected
+  if handle.detect(padded, pitch=pitch + 1, offset=offset):
+    return 'Image with rows outside of buffer should be rejected'
+  return ''
+
+def test_ARHandleBottomOrigin ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  # image with rows stored bottom-up, as OpenGL reads them
+  rowSize = handle.size[0] * 3
+  flipped = b''.join(image[row * rowSize:(row + 1) * rowSize] for row in reversed(range(handle.size[1])))
+  # bottom-up image is detected in luminance plane
+  handle.lumaConversion = True
+  rslt = detectMarker(handle, image)
+  if rslt != '':
+    return rslt
+  cf = handle.markers[0].cf
+  handle.lumaConversion = False
+  handle.origin = 'bottom'
+  if handle.origin != 'bottom':
+    return 'Origin should be bottom'
+  stats = handle.ingestStats
+  rslt = detectMarker(handle, flipped)
+  if rslt != '':
+    return rslt
+  # rows are read by luminance conversion, they aren't copied first
+  if handle.ingestStats['converted'] != stats['converted'] + 1 or handle.ingestStats['repacked'] != 0:
+    return 'Bottom-up image should be converted without repacking'
+  # marker is detected in the same top-down image
+  if abs(handle.markers[0].cf - cf) > 1e-6:
+    return 'Marker should match detection in top-down image'
+  handle.origin = 'top'
+  try:
+    handle.origin = 'left'
+    return 'Invalid origin should raise exception'
+  except ValueError:
+    pass
+  return detectMarker(handle, image)
+
+def test_ARHandlePlanarYUV ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (254, 207)
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', param.size, 3)
+  if isinstance(image, str):
+    return image
+  # NV21 frame with green component as luminance and neutral chroma
+  luma = image[1::3]
+  chroma = bytes([128]) * (param.size[0] * ((param.size[1] + 1) // 2))
+  handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.NV21)
+  handle.attachPatt = ARTKBlender.ARPattHandle()
+  if handle.attachPatt.load('../../UnitTests/Data/hiro.patt') != 0:
+    return 'Invalid pattern ID'
+  # luminance plane alone, the whole frame and tuple of planes
+  for frame in (luma, luma + chroma, (luma, chroma)):
+    stats = handle.ingestStats
+    rslt = detectMarker(handle, frame)
+    if rslt != '':
+      return rslt
+    if handle.ingestStats['direct'] != stats['direct'] + 1:
+      return 'Luminance plane should be detected in place'
+  # luminance plane after header of frame
+  if not handle.detect(bytes(32) + luma + chroma, offset=32) or len(handle.markers) != 1:
+    return 'Detection in luminance plane at offset failed'
+  if handle.detect(luma[:-1]):
+    return 'Incomplete luminance plane should be rejected'
+  return ''
+
+def test_ARHandleFrameSkipping ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  handle.frameSkipping = True
+  stats = handle.frameSkipStats
+  # the first image is detected, identical images are skipped
+  for i in range(3):
+    rslt = detectMarker(handle, image)
+    if rslt != '':
+      return rslt
+  if handle.frameSkipStats['misses'] != stats['misses'] + 1 or handle.frameSkipStats['hits'] != stats['hits'] + 2:
+    return 'Identical images should be skipped'
+  # skipped image keeps markers with capture time of detected one
+  timestamp = handle.markers[0].timestamp
+  if not handle.detect(image, 1000.0) or not handle.detect(image, 2000.0):
+    return 'Detection of identical image failed'
+  if handle.markers[0].timestamp != timestamp:
+    return 'Markers of skipped image shouldn\'t change their timestamp'
+  # changed image and changed settings are detected
+  changed = bytearray(image)
+  changed[0] ^= 1
+  rslt = detectMarker(handle, changed)
+  if rslt != '':
+    return rslt
+  handle.labelingThresh = handle.labelingThresh + 1
+  rslt = detectMarker(handle, changed)
+  if rslt != '':
+    return rslt
+  if handle.frameSkipStats['misses'] != stats['misses'] + 3:
+    return 'Changed image or settings should be detected'
+  handle.frameSkipping = False
+  return detectMarker(handle, image)
+
+def test_ARHandleTileDetection ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  handle.tileDetection = True
+  handle.tileSize = 16
+  # the first image is scanned fully, unchanged image reuses its squares
+  for i in range(2):
+    rslt = detectMarker(handle, image)
+    if rslt != '':
+      return rslt
+  stats = handle.tileStats
+  if stats['full'] != 1 or stats['incremental'] != 1 or stats['changed'] != 0:
+    return 'Unchanged image should be detected incrementally'
+  # inverted corner of image is labeled again
+  changed = bytearray(image)
+  for row in range(8):
+    start = row * handle.size[0] * 3
+    changed[start:start + 24] = bytes(255 - value for value in changed[start:start + 24])
+  rslt = detectMarker(handle, changed)
+  if rslt != '':
+    return rslt
+  if handle.tileStats['changed'] == 0:
+    return 'Changed tile should be found'
+  try:
+    handle.tileSize = 15
+    return 'Odd tile size should raise exception'
+  except ValueError:
+    pass
+  handle.tileDetection = False
+  return detectMarker(handle, image)
+
+def test_ARHandleTileDetectionFieldImage ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (400, 320)
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', (254, 207), 3)
+  if isinstance(image, str):
+    return image
+  frame = embedImage(image, (254, 207), param.size, (120, 90))
+  # brighter bottom-right part of frame is labeled again in region away from top-left corner
+  changed = bytearray(frame)
+  for row in range(64, param.size[1]):
+    start = (row * param.size[0] + 64) * 3
+    end = (row + 1) * param.size[0] * 3
+    changed[start:end] = bytes(min(255, value + 8) for value in changed[start:end])
+  handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB)
+  handle.attachPatt = ARTKBlender.ARPattHandle()
+  if handle.attachPatt.load('../../UnitTests/Data/hiro.patt') != 0:
+    return 'Invalid pattern ID'
+  handle.imageProcMode = ARTKBlender.ARImageProcMode.FIELD_IMAGE
+  rslt = detectMarker(handle, changed)
+  if rslt != '':
+    return rslt
+  pos = struct.unpack_from('iii4xddd', handle.markerArray)[4:6]
+  handle.tileDetection = True
+  for image in (frame, changed):
+    rslt = detectMarker(handle, image)
+    if rslt != '':
+      return rslt
+  stats = handle.tileStats
+  if stats['full'] != 1 or stats['incremental'] != 1 or stats['changed'] == 0:
+    return 'Changed frame should be detected incrementally: ' + str(stats)
+  tilePos = struct.unpack_from('iii4xddd', handle.markerArray)[4:6]
+  if abs(tilePos[0] - pos[0]) > 1.0 or abs(tilePos[1] - pos[1]) > 1.0:
+    return 'Marker found in changed tiles is shifted: ' + str(tilePos) + ' instead of ' + str(pos)
+  return ''
+
+def test_ARHandleTileDetectionAutoThreshold ():
+  rslt = performMarkerDetection()
+  if isinstance(rslt, str):
+    return rslt
+  handle = rslt[0]
+  image = loadImage('../../UnitTests/Data/hiro_marker.raw', handle.size, 3)
+  if isinstance(image, str):
+    return image
+  handle.labelingThreshMode = ARTKBlender.ARLabelingThreshMode.AUTO_MEDIAN
+  handle.tileDetection = True
+  # threshold computed by full scan doesn't force next full scan
+  for i in range(3):
+    rslt = detectMarker(handle, image)
+    if rslt != '':
+      return rslt
+  stats = handle.tileStats
+  if stats['full'] != 1 or stats['incremental'] != 2:
+    return 'Automatic threshold should keep incremental detection: ' + str(stats)
+  # threshold image of adaptive mode isn't available for tiles
+  try:
+    handle.labelingThreshMode = ARTKBlender.ARLabelingThreshMode.AUTO_ADAPTIVE
+    return 'Adaptive threshold should be rejected with tile detection'
+  except ValueError:
+    pass
+  return ''
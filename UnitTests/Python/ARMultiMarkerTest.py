@@ -0,0 +1,62 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+import ARTKBlender
+import ARHandleTest
+import AR3DHandleTest
+
+
+def createMultiMarker ():
+  pattHandle = ARTKBlender.ARPattHandle()
+  multiMarker = ARTKBlender.ARMultiMarker('../../UnitTests/Data/hiro_multi.dat', pattHandle)
+  return (multiMarker, pattHandle)
+
+def test_ARMultiMarkerLoad ():
+  multiMarker = createMultiMarker()[0]
+  if multiMarker.markerCount != 1:
+    return 'Configuration should contain one marker'
+  try:
+    ARTKBlender.ARMultiMarker('../../UnitTests/Data/missing.dat', ARTKBlender.ARPattHandle())
+    return 'Loading of missing configuration should fail'
+  except IOError:
+    return ''
+
+def test_ARMultiMarkerTransMat ():
+  param = ARTKBlender.ARParam()
+  if not param.load('../../UnitTests/Data/camera_para.dat'):
+    return 'Parameters load failed'
+  param.size = (254, 207)
+  image = ARHandleTest.loadImage('../../UnitTests/Data/hiro_marker.raw', param.size, 3)
+  if isinstance(image, str):
+    return image
+  multiMarker, pattHandle = createMultiMarker()
+  handle = ARTKBlender.ARHandle(param, ARTKBlender.ARPixelFormat.RGB)
+  handle.attachPatt = pattHandle
+  handle3D = ARTKBlender.AR3DHandle(param)
+  if multiMarker.getTransMat(handle3D, handle) is not None:
+    return 'No matrix should be available without detected markers'
+  if not handle.detect(image):
+    return 'Marker detection failed'
+  mat = multiMarker.getTransMat(handle3D, handle)
+  if mat is None:
+    return 'Multi-marker matrix should be available'
+  if multiMarker.markersUsed != 1 or multiMarker.error < 0.0:
+    return 'Invalid number of used markers or error'
+  return AR3DHandleTest.checkMatrix(mat, ((0.9, -0.3, 0.3),(0.4, 0.7, -0.6),(0.0, 0.65, 0.75)), (7.0, 13.0, -270.0))
@@ -0,0 +1,61 @@
+# -----------------------------------------------------------------------------
+# This source file is part of ARTKBlender library
+#
+# Copyright (c) 2016 The Zdeno Ash Miklas
+#
+# ARTKBlender is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+# 
+# Foobar is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+# 
+# You should have received a copy of the GNU General Public License
+# along with ARTKBlender.  If not, see <http://www.gnu.org/licenses/>.
+# -----------------------------------------------------------------------------
+
+
+import struct
+import ARTKBlender
+
+
+def createPoses (translations):
+  values = []
+  for x, y, z in translations:
+    values += [1.0, 0.0, 0.0, x, 0.0, 1.0, 0.0, y, 0.0, 0.0, 1.0, z, 0.0, 0.0, 0.0, 1.0]
+  return memoryview(bytearray(struct.pack('{}d'.format(len(values)), *values))).cast('d', (len(translations), 4, 4))
+
+def test_ARPoseFilterConstruct ():
+  poseFilter = ARTKBlender.ARPoseFilter(minCutoff=2.0, beta=0.5)
+  if poseFilter.minCutoff != 2.0 or poseFilter.beta != 0.5 or poseFilter.derivativeCutoff != 1.0:
+    return 'Invalid filter parameters'
+  try:
+    ARTKBlender.ARPoseFilter(minCutoff=0.0)
+    return 'Zero cutoff should be rejected'
+  except ValueError:
+    pass
+  try:
+    poseFilter.beta = -1.0
+    return 'Negative beta should be rejected'
+  except ValueError:
+    return ''
+
+def test_ARPoseFilterFilter ():
+  poseFilter = ARTKBlender.ARPoseFilter()
+  mats = poseFilter.filter((0, 1), createPoses(((0.0, 0.0, -100.0), (10.0, 0.0, -200.0))), 0.0)
+  if mats.shape != (2, 4, 4) or mats[0, 2, 3] != -100.0 or mats[1, 0, 3] != 10.0:
+    return 'The first poses should not be changed'
+  poses = createPoses(((0.0, 0.0, -110.0), (10.0, 0.0, -200.0)))
+  mats = poseFilter.filter((0, 1), poses, 0.1, out=poses)
+  if mats is not poses:
+    return 'Supplied output buffer should be returned'
+  if not -110.0 < mats[0, 2, 3] < -100.0:
+    return 'Translation should be smoothed'
+  if abs(mats[1, 0, 3] - 10.0) > 1e-9 or abs(mats[0, 0, 0] - 1.0) > 1e-9 or abs(mats[0, 3, 3] - 1.0) > 1e-9:
+    return 'Unchanged pose should stay the same'
+  poseFilter.reset()
+  mats = poseFilter.filter((0,), createPoses(((0.0, 0.0, -110.0),)), 0.2)
+  return '' if mats[0, 2, 3] == -110.0 else 'Pose should not be filtered after reset'